@@ -2,54 +2,158 @@
 #pragma once
 
 #include <cstddef>
+#include <new>
+#include <algorithm>
 #include <stdexcept>
 #include <vector>
 #include <cassert>
 #include <forward_list>
+#include <memory>
+#include <memory_resource>
+#include <tuple>
+#include <functional>
+#include <atomic>
+#include <mutex>
+#include <cstdint>
+#include <chrono>
+#include <unordered_set>
 #include "pod_vector.hpp"
 
+#if !defined(NDEBUG)
+#include <iostream>
+#endif
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#endif
+
+
+#ifndef SC_CACHE_LINE_SIZE
+#define SC_CACHE_LINE_SIZE 64
+#endif
 
 namespace sc {
 
-    // TODO Allow block to store other types (with less size / align constraints)
+    // Statistics policies, called on each allocation and deallocation
+
+    namespace block_stats {
+
+        // No statistics
+        struct none {
+        protected:
+            void on_allocate(void*, int) {}
+            void on_deallocate(void*, int) {}
+        };
+
+        // Allocations count and rate, peak usage
+        class counters {
+        public:
+            long long allocations() const   { return allocations_; }
+            long long deallocations() const { return deallocations_; }
+            int peak_size() const           { return peakSize_; }
+
+            // Allocations per second since the resource creation
+            double allocation_rate() const {
+                const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - creation_;
+                return allocations_ / elapsed.count();
+            }
+        protected:
+            void on_allocate(void*, int size) {
+                ++allocations_;
+                peakSize_ = std::max(peakSize_, size);
+            }
+            void on_deallocate(void*, int) {
+                ++deallocations_;
+            }
+        private:
+            long long allocations_ = 0;
+            long long deallocations_ = 0;
+            int peakSize_ = 0;
+            std::chrono::steady_clock::time_point creation_ = std::chrono::steady_clock::now();
+        };
+
+        // Counters, double free detection and leaks report at the resource destruction.
+        // Compiled away in release builds.
+#if defined(NDEBUG)
+        using debug = none;
+#else
+        class debug : public counters {
+        public:
+            ~debug() {
+                if (blocks_.empty()) return;
+                std::cerr << "block_allocator_resource destroyed with " << blocks_.size() << " leaked blocks :";
+                for (void* ptr : blocks_) std::cerr << ' ' << ptr;
+                std::cerr << std::endl;
+            }
+
+            int leaks() const { return static_cast<int>(blocks_.size()); }
+        protected:
+            void on_allocate(void* ptr, int size) {
+                counters::on_allocate(ptr, size);
+                blocks_.insert(ptr);
+            }
+            void on_deallocate(void* ptr, int size) {
+                const bool allocated = blocks_.erase(ptr) == 1;
+                assert(allocated && "The block is deallocated twice or has not been allocated by this resource");
+                counters::on_deallocate(ptr, size);
+            }
+        private:
+            std::unordered_set<void*> blocks_;
+        };
+#endif
+    }
 
-    template <bool DYNAMIC, class T>
+    template <bool DYNAMIC, class T, class Stats = block_stats::none>
     class block_allocator_resource;
 
+    // The resources give the deallocated blocks first, then the never used blocks in memory order,
+    // so the memory is only touched when it is given for the first time.
+
     // Static resource
 
-    template <class T>
-    class block_allocator_resource<false, T> {
+    template <class T, class Stats>
+    class block_allocator_resource<false, T, Stats> : private Stats {
     public:
         explicit block_allocator_resource(int size) :
             size_(0),
-            blocks_(size)
-        {
-            for (int i = 0; i < size - 1; ++i) {
-                blocks_[i].pNext = blocks_.data() + i + 1;
-            }
-            blocks_.back().pNext = nullptr;
-            pNext_ = blocks_.data();
-        }
+            pNext_(nullptr),
+            blocks_(size),
+            bump_(blocks_.data())
+        {}
         block_allocator_resource(block_allocator_resource&&) = delete;
         block_allocator_resource& operator=(block_allocator_resource&&) = delete;
 
         T* allocate() {
-            assert(pNext_ != nullptr);
-            auto ptr = reinterpret_cast<T*>(pNext_);
-            pNext_ = pNext_->pNext;
-            ++size_;
+            T* ptr;
+            if (pNext_ == nullptr) {
+                assert(bump_ != blocks_.data() + blocks_.size());
+                ptr = reinterpret_cast<T*>(bump_++);
+            }
+            else {
+                ptr = reinterpret_cast<T*>(pNext_);
+                pNext_ = pNext_->pNext;
+            }
+            this->on_allocate(ptr, ++size_);
             return ptr;
         }
         void deallocate(T* ptr) {
+            this->on_deallocate(ptr, --size_);
             auto nodePtr = reinterpret_cast<node_t*>(ptr);
             nodePtr->pNext = pNext_;
             pNext_ = nodePtr;
-            --size_;
+        }
+
+        // No block can be allocated until one is deallocated
+        bool exhausted() const { return pNext_ == nullptr && bump_ == blocks_.data() + blocks_.size(); }
+        // The block is in the resource buffer
+        bool owns(void const* ptr) const {
+            return std::less_equal<void const*>()(blocks_.data(), ptr) &&
+                   std::less<void const*>()(ptr, blocks_.data() + blocks_.size());
         }
 
         int size() const { return size_; }
         int capacity() const { return blocks_.size(); }
+        Stats const& stats() const { return *this; }
     private:
         struct alignas(alignof(T)) node_t {
             union {
@@ -61,69 +165,313 @@ namespace sc {
         int size_;
         node_t* pNext_;
         sc::pod_vector<node_t> blocks_;
+        node_t* bump_;
     };
 
     // Dynamic resource
 
-    template <class T>
-    class block_allocator_resource<true, T> {
+    /// Each new chunk is twice bigger than the previous one, up to max_chunk_bytes.
+    /// Chunks bigger than a huge page are mapped with transparent huge pages on Linux.
+    /// trim() gives the chunks without allocated blocks back to the system.
+    template <class T, class Stats>
+    class block_allocator_resource<true, T, Stats> : private Stats {
     public:
+        static constexpr size_t max_chunk_bytes = size_t(256) << 20;
+        static constexpr size_t huge_page_bytes = size_t(2) << 20;
+
         explicit block_allocator_resource(int size) :
                 size_(0),
-                blocksCount_(0),
-                blocksSize_(size)
+                pNext_(nullptr),
+                bump_(nullptr),
+                bumpEnd_(nullptr),
+                capacity_(0),
+                nextChunkSize_(size)
         {
             make_blocks();
         }
+        ~block_allocator_resource() {
+            for (auto& chunk : chunks_) release_chunk(chunk);
+        }
         block_allocator_resource(block_allocator_resource&&) = delete;
         block_allocator_resource& operator=(block_allocator_resource&&) = delete;
 
         T* allocate() {
+            T* ptr;
             if (pNext_ == nullptr) {
-                make_blocks();
+                if (bump_ == bumpEnd_) {
+                    make_blocks();
+                }
+                ptr = reinterpret_cast<T*>(bump_++);
+            }
+            else {
+                ptr = reinterpret_cast<T*>(pNext_);
+                pNext_ = pNext_->pNext;
             }
-            auto ptr = reinterpret_cast<T*>(pNext_);
-            pNext_ = pNext_->pNext;
-            ++size_;
+            this->on_allocate(ptr, ++size_);
             return ptr;
         }
         void deallocate(T* ptr) {
+            this->on_deallocate(ptr, --size_);
             auto nodePtr = reinterpret_cast<node_t*>(ptr);
             nodePtr->pNext = pNext_;
             pNext_ = nodePtr;
-            --size_;
         }
 
+        // Release the chunks which have no allocated blocks and returns the number of released blocks.
+        // The chunks occupancy is computed from the free list, so it costs O(free blocks * log(chunks)).
+        int trim();
+
+        // Ratio of allocated blocks in each chunk, sorted by address. Costs as much as trim().
+        std::vector<float> chunks_fill() const;
+
         int size() const { return size_; }
-        int capacity() const { return blocksCount_ * blocksSize_; }
+        int capacity() const { return capacity_; }
+        Stats const& stats() const { return *this; }
     private:
-        void make_blocks() {
-            ++blocksCount_;
-            auto& vec = blocks_.emplace_front(blocksSize_);
-            for (int i = 0; i < blocksSize_ - 1; ++i) {
-                vec[i].pNext = vec.data() + i + 1;
-            }
-            vec.back().pNext = nullptr;
-            pNext_ = vec.data();
-        }
-
         struct alignas(alignof(T)) node_t {
             union {
                 std::aligned_storage_t<sizeof(T), alignof(T)> storage;
                 node_t* pNext;
             };
         };
+        struct chunk_t {
+            node_t* data;
+            int size;
+        };
+
+        void make_blocks();
+        int find_chunk(void const* ptr) const;
+        std::vector<int> free_counts() const;
+
+        static void allocate_chunk(chunk_t& chunk);
+        static void release_chunk(chunk_t& chunk);
+        static size_t mapped_bytes(int size);
 
         int size_;
         node_t* pNext_;
-        int blocksCount_;
-        int blocksSize_;
-        std::forward_list<sc::pod_vector<node_t>> blocks_;
+        node_t* bump_;    // Never used blocks of the last chunk
+        node_t* bumpEnd_;
+        int capacity_;
+        int nextChunkSize_;
+        std::vector<chunk_t> chunks_; // Sorted by address
+    };
+
+    // Concurrent resource
+
+    /// Thread-safe dynamic resource. Each thread allocates and deallocates through its own local_cache,
+    /// a free list without synchronization which exchanges batches of blocks with a shared lock-free depot.
+    /// A block can be deallocated by another thread than the one which allocated it.
+    /// Only the creation of new chunks takes a lock. The caches must be destroyed before the resource.
+    template <class T>
+    class concurrent_block_allocator_resource {
+        struct node_t;
+    public:
+        class local_cache {
+        public:
+            explicit local_cache(concurrent_block_allocator_resource& resource) :
+                    resource_(resource),
+                    pNext_(nullptr),
+                    size_(0)
+            {}
+            local_cache(local_cache&&) = delete;
+            local_cache& operator=(local_cache&&) = delete;
+
+            ~local_cache() {
+                if (pNext_ != nullptr) resource_.push_batch(pNext_);
+            }
+
+            T* allocate() {
+                if (pNext_ == nullptr) {
+                    pNext_ = resource_.pop_batch();
+                    for (node_t* node = pNext_; node != nullptr; node = node->links.pNext) ++size_;
+                }
+                auto ptr = reinterpret_cast<T*>(pNext_);
+                pNext_ = pNext_->links.pNext;
+                --size_;
+                return ptr;
+            }
+            void deallocate(T* ptr) {
+                auto nodePtr = reinterpret_cast<node_t*>(ptr);
+                nodePtr->links.pNext = pNext_;
+                pNext_ = nodePtr;
+                if (++size_ == 2 * resource_.batchSize_) flush_batch();
+            }
+        private:
+            // Give the first batchSize blocks to the depot
+            void flush_batch() {
+                node_t* batch = pNext_;
+                node_t* last = pNext_;
+                for (int i = 1; i < resource_.batchSize_; ++i) last = last->links.pNext;
+                pNext_ = last->links.pNext;
+                last->links.pNext = nullptr;
+                size_ -= resource_.batchSize_;
+                resource_.push_batch(batch);
+            }
+
+            concurrent_block_allocator_resource& resource_;
+            node_t* pNext_;
+            int size_;
+        };
+
+        explicit concurrent_block_allocator_resource(int chunkSize, int batchSize = 32) :
+                depot_(0),
+                chunksCount_(0),
+                chunkSize_(chunkSize),
+                batchSize_(batchSize)
+        {
+            static_assert(sizeof(void*) == 8, "The depot stores an ABA counter in the 16 upper bits of pointers");
+        }
+        concurrent_block_allocator_resource(concurrent_block_allocator_resource&&) = delete;
+        concurrent_block_allocator_resource& operator=(concurrent_block_allocator_resource&&) = delete;
+
+        int capacity() const { return chunksCount_.load(std::memory_order_relaxed) * chunkSize_; }
+    private:
+        static constexpr uint64_t pointer_mask = (uint64_t(1) << 48) - 1;
+
+        static uint64_t pack(node_t* ptr, uint64_t counter) {
+            assert((static_cast<uint64_t>(reinterpret_cast<uintptr_t>(ptr)) & ~pointer_mask) == 0);
+            return static_cast<uint64_t>(reinterpret_cast<uintptr_t>(ptr)) | (counter << 48);
+        }
+        static node_t* unpack(uint64_t value) {
+            return reinterpret_cast<node_t*>(static_cast<uintptr_t>(value & pointer_mask));
+        }
+
+        void push_batch(node_t* batch) {
+            uint64_t head = depot_.load(std::memory_order_relaxed);
+            do {
+                batch->links.pNextBatch.store(unpack(head), std::memory_order_relaxed);
+            } while (!depot_.compare_exchange_weak(head, pack(batch, (head >> 48) + 1),
+                                                   std::memory_order_release, std::memory_order_relaxed));
+        }
+
+        node_t* pop_batch() {
+            uint64_t head = depot_.load(std::memory_order_acquire);
+            while (node_t* batch = unpack(head)) {
+                // The batch may have been popped and reused meanwhile, then the counter makes the exchange fail
+                node_t* next = batch->links.pNextBatch.load(std::memory_order_relaxed);
+                if (depot_.compare_exchange_weak(head, pack(next, (head >> 48) + 1),
+                                                 std::memory_order_acquire, std::memory_order_acquire)) {
+                    return batch;
+                }
+            }
+            return make_chunk();
+        }
+
+        // Split a new chunk in batches, keep the first one and push the others in the depot
+        node_t* make_chunk() {
+            node_t* data;
+            {
+                std::lock_guard lock{chunksMutex_};
+                data = chunks_.emplace_front(new node_t[chunkSize_]).get();
+            }
+            chunksCount_.fetch_add(1, std::memory_order_relaxed);
+
+            for (int first = 0; first < chunkSize_; first += batchSize_) {
+                const int last = std::min(first + batchSize_, chunkSize_) - 1;
+                for (int i = first; i < last; ++i) {
+                    data[i].links.pNext = data + i + 1;
+                }
+                data[last].links.pNext = nullptr;
+                if (first != 0) push_batch(data + first);
+            }
+            return data;
+        }
+
+        struct alignas(alignof(T)) node_t {
+            struct links_t {
+                node_t* pNext;      // Next block in the batch
+                // Next batch in the depot, set on the first block of a batch.
+                // Atomic since a concurrent pop_batch can read it while the batch is popped and pushed again.
+                std::atomic<node_t*> pNextBatch;
+            };
+            union {
+                std::aligned_storage_t<sizeof(T), alignof(T)> storage;
+                links_t links;
+            };
+        };
+
+        alignas(SC_CACHE_LINE_SIZE) std::atomic<uint64_t> depot_;
+        alignas(SC_CACHE_LINE_SIZE) std::mutex chunksMutex_;
+        std::forward_list<std::unique_ptr<node_t[]>> chunks_;
+        std::atomic<int> chunksCount_;
+        const int chunkSize_;
+        const int batchSize_;
+    };
+
+    // Size classes resource
+
+    /// Memory resource for small objects of any type, with one dynamic block_allocator_resource per size class
+    /// (powers of two from 8 to 512 bytes, blocks aligned on their size).
+    /// Bigger or over-aligned requests are forwarded to the upstream resource.
+    class block_pool_resource final : public std::pmr::memory_resource {
+    public:
+        static constexpr size_t min_block_size = 8;
+        static constexpr size_t max_block_size = 512;
+
+        explicit block_pool_resource(int chunkSize = 256,
+                                     std::pmr::memory_resource* upstream = std::pmr::get_default_resource()) :
+                resources_(chunkSize, chunkSize, chunkSize, chunkSize, chunkSize, chunkSize, chunkSize),
+                upstream_(upstream)
+        {}
+        block_pool_resource(block_pool_resource&&) = delete;
+        block_pool_resource& operator=(block_pool_resource&&) = delete;
+
+        std::pmr::memory_resource* upstream_resource() const { return upstream_; }
+    private:
+        template <size_t SIZE>
+        struct alignas(SIZE) block_t {
+            std::byte data[SIZE];
+        };
+        template <size_t SIZE>
+        using resource_t = block_allocator_resource<true, block_t<SIZE>>;
+
+        // Returns the index of the size class, or -1 if the request is too big
+        static int size_class(size_t bytes, size_t alignment) {
+            size_t size = std::max(std::max(bytes, alignment), min_block_size);
+            if (size > max_block_size) return -1;
+            int index = 0;
+            for (size_t blockSize = min_block_size; blockSize < size; blockSize *= 2) ++index;
+            return index;
+        }
+
+        void* do_allocate(size_t bytes, size_t alignment) override {
+            switch (size_class(bytes, alignment)) {
+                case 0:  return std::get<0>(resources_).allocate();
+                case 1:  return std::get<1>(resources_).allocate();
+                case 2:  return std::get<2>(resources_).allocate();
+                case 3:  return std::get<3>(resources_).allocate();
+                case 4:  return std::get<4>(resources_).allocate();
+                case 5:  return std::get<5>(resources_).allocate();
+                case 6:  return std::get<6>(resources_).allocate();
+                default: return upstream_->allocate(bytes, alignment);
+            }
+        }
+        void do_deallocate(void* ptr, size_t bytes, size_t alignment) override {
+            switch (size_class(bytes, alignment)) {
+                case 0:  std::get<0>(resources_).deallocate(static_cast<block_t<8>*>  (ptr)); break;
+                case 1:  std::get<1>(resources_).deallocate(static_cast<block_t<16>*> (ptr)); break;
+                case 2:  std::get<2>(resources_).deallocate(static_cast<block_t<32>*> (ptr)); break;
+                case 3:  std::get<3>(resources_).deallocate(static_cast<block_t<64>*> (ptr)); break;
+                case 4:  std::get<4>(resources_).deallocate(static_cast<block_t<128>*>(ptr)); break;
+                case 5:  std::get<5>(resources_).deallocate(static_cast<block_t<256>*>(ptr)); break;
+                case 6:  std::get<6>(resources_).deallocate(static_cast<block_t<512>*>(ptr)); break;
+                default: upstream_->deallocate(ptr, bytes, alignment);
+            }
+        }
+        bool do_is_equal(std::pmr::memory_resource const& other) const noexcept override {
+            return this == &other;
+        }
+
+        std::tuple<
+            resource_t<8>, resource_t<16>, resource_t<32>, resource_t<64>,
+            resource_t<128>, resource_t<256>, resource_t<512>
+        > resources_;
+        std::pmr::memory_resource* upstream_;
     };
 
     // Allocator
 
-    template <bool DYNAMIC, class T>
+    template <bool DYNAMIC, class T, class Stats = block_stats::none>
     class block_allocator {
     public:
         using value_type = T;
@@ -131,9 +479,9 @@ namespace sc {
         using propagate_on_container_copy_assignment = std::true_type;
         using is_always_equal = std::false_type;
 
-        explicit block_allocator(block_allocator_resource<DYNAMIC, T>& resource) : resource_(resource) {}
+        explicit block_allocator(block_allocator_resource<DYNAMIC, T, Stats>& resource) : resource_(resource) {}
 
-        // Must not be rebind
+        // Must not be rebind, see block_pool_allocator for node-based containers
 
         T* allocate(size_t nb) {
             assert(nb == 1);
@@ -143,17 +491,219 @@ namespace sc {
             assert(nb == 1);
             resource_.deallocate(ptr);
         }
+
+        block_allocator_resource<DYNAMIC, T, Stats>& resource() const { return resource_; }
+    private:
+        block_allocator_resource<DYNAMIC, T, Stats>& resource_;
+    };
+
+    template <bool DYNAMIC, class T, class U, class Stats>
+    bool operator==(block_allocator<DYNAMIC, T, Stats> const& lhs, block_allocator<DYNAMIC, U, Stats> const& rhs) {
+        return static_cast<void const*>(&lhs.resource()) == static_cast<void const*>(&rhs.resource());
+    };
+    template <bool DYNAMIC, class T, class U, class Stats>
+    bool operator!=(block_allocator<DYNAMIC, T, Stats> const& lhs, block_allocator<DYNAMIC, U, Stats> const& rhs) {
+        return static_cast<void const*>(&lhs.resource()) != static_cast<void const*>(&rhs.resource());
+    };
+
+    // Polymorphic resource
+
+    /// std::pmr::memory_resource giving the blocks of a block_allocator_resource, for std::pmr containers.
+    /// Requests which do not fit in one block, or arriving when a static resource is exhausted, are forwarded
+    /// to the upstream resource.
+    template <bool DYNAMIC, class T, class Stats = block_stats::none>
+    class block_memory_resource final : public std::pmr::memory_resource {
+    public:
+        using resource_t = block_allocator_resource<DYNAMIC, T, Stats>;
+
+        explicit block_memory_resource(resource_t& resource,
+                                       std::pmr::memory_resource* upstream = std::pmr::get_default_resource()) :
+                resource_(resource),
+                upstream_(upstream)
+        {}
+
+        resource_t& resource() const { return resource_; }
+        std::pmr::memory_resource* upstream_resource() const { return upstream_; }
+    private:
+        static bool fits(size_t bytes, size_t alignment) {
+            return bytes <= sizeof(T) && alignment <= alignof(T);
+        }
+
+        void* do_allocate(size_t bytes, size_t alignment) override {
+            if (fits(bytes, alignment)) {
+                if constexpr (DYNAMIC) return resource_.allocate();
+                else if (!resource_.exhausted()) return resource_.allocate();
+            }
+            return upstream_->allocate(bytes, alignment);
+        }
+        void do_deallocate(void* ptr, size_t bytes, size_t alignment) override {
+            // Blocks fitting in a static resource may have been allocated upstream, so the address decides
+            bool pooled = fits(bytes, alignment);
+            if constexpr (!DYNAMIC) pooled = pooled && resource_.owns(ptr);
+
+            if (pooled) resource_.deallocate(static_cast<T*>(ptr));
+            else upstream_->deallocate(ptr, bytes, alignment);
+        }
+        bool do_is_equal(std::pmr::memory_resource const& other) const noexcept override {
+            return this == &other;
+        }
+
+        resource_t& resource_;
+        std::pmr::memory_resource* upstream_;
+    };
+
+    // Rebindable allocator
+
+    /// Allocator for node-based containers (std::list, std::map, std::unordered_map...), which rebind it to their nodes.
+    /// Each node type is served by the size class of the block_pool_resource matching its size and alignment,
+    /// so the allocators of the same size share their blocks. Arrays bigger than the size classes go upstream.
+    template <class T>
+    class block_pool_allocator {
+    public:
+        using value_type = T;
+        using propagate_on_container_move_assignment = std::true_type;
+        using propagate_on_container_copy_assignment = std::true_type;
+        using is_always_equal = std::false_type;
+
+        template <class U>
+        struct rebind { using other = block_pool_allocator<U>; };
+
+        explicit block_pool_allocator(block_pool_resource& resource) : resource_(&resource) {}
+        template <class U>
+        block_pool_allocator(block_pool_allocator<U> const& allocator) : resource_(allocator.resource()) {}
+
+        T* allocate(size_t nb) {
+            return static_cast<T*>(resource_->allocate(nb * sizeof(T), alignof(T)));
+        }
+        void deallocate(T* ptr, size_t nb) {
+            resource_->deallocate(ptr, nb * sizeof(T), alignof(T));
+        }
+
+        block_pool_resource* resource() const { return resource_; }
     private:
-        block_allocator_resource<DYNAMIC, T>& resource_;
+        block_pool_resource* resource_;
     };
 
-    template <bool DYNAMIC, class T, class U>
-    bool operator==(block_allocator<DYNAMIC, T> const& lhs, block_allocator<DYNAMIC, U> const& rhs) {
-        return &lhs.resource_ == &rhs.resource_;
+    template <class T, class U>
+    bool operator==(block_pool_allocator<T> const& lhs, block_pool_allocator<U> const& rhs) {
+        return lhs.resource() == rhs.resource();
     };
-    template <bool DYNAMIC, class T, class U>
-    bool operator!=(block_allocator<DYNAMIC, T> const& lhs, block_allocator<DYNAMIC, U> const& rhs) {
-        return &lhs.resource_ != &rhs.resource_;
+    template <class T, class U>
+    bool operator!=(block_pool_allocator<T> const& lhs, block_pool_allocator<U> const& rhs) {
+        return lhs.resource() != rhs.resource();
     };
 
+    // ______________
+    // Implementation
+
+    // Dynamic resource
+
+    template <class T, class Stats>
+    void block_allocator_resource<true, T, Stats>::make_blocks() {
+        chunk_t chunk { nullptr, nextChunkSize_ };
+        allocate_chunk(chunk);
+        const auto it = std::upper_bound(chunks_.begin(), chunks_.end(), chunk.data, [] (node_t* ptr, chunk_t const& c) {
+            return ptr < c.data;
+        });
+        chunks_.insert(it, chunk);
+
+        bump_ = chunk.data;
+        bumpEnd_ = chunk.data + chunk.size;
+
+        capacity_ += chunk.size;
+        const auto maxChunkSize = static_cast<int>(std::max(max_chunk_bytes / sizeof(node_t), size_t(1)));
+        nextChunkSize_ = nextChunkSize_ > maxChunkSize / 2 ? std::max(maxChunkSize, nextChunkSize_) : nextChunkSize_ * 2;
+    }
+
+    template <class T, class Stats>
+    int block_allocator_resource<true, T, Stats>::find_chunk(void const* ptr) const {
+        const auto it = std::upper_bound(chunks_.begin(), chunks_.end(), ptr, [] (void const* p, chunk_t const& c) {
+            return p < static_cast<void const*>(c.data);
+        });
+        return static_cast<int>(it - chunks_.begin()) - 1;
+    }
+
+    template <class T, class Stats>
+    std::vector<int> block_allocator_resource<true, T, Stats>::free_counts() const {
+        std::vector<int> freeCounts(chunks_.size());
+        for (node_t* node = pNext_; node != nullptr; node = node->pNext) {
+            ++freeCounts[find_chunk(node)];
+        }
+        if (bump_ != bumpEnd_) {
+            freeCounts[find_chunk(bump_)] += static_cast<int>(bumpEnd_ - bump_);
+        }
+        return freeCounts;
+    }
+
+    template <class T, class Stats>
+    std::vector<float> block_allocator_resource<true, T, Stats>::chunks_fill() const {
+        auto fill = std::vector<float>(chunks_.size());
+        const auto freeCounts = free_counts();
+        for (size_t i = 0; i < chunks_.size(); ++i) {
+            fill[i] = 1.f - static_cast<float>(freeCounts[i]) / chunks_[i].size;
+        }
+        return fill;
+    }
+
+    template <class T, class Stats>
+    int block_allocator_resource<true, T, Stats>::trim() {
+        const auto freeCounts = free_counts();
+        const int bumpChunk = bump_ != bumpEnd_ ? find_chunk(bump_) : -1;
+
+        // Unlink the blocks of the chunks to release
+        node_t** pLink = &pNext_;
+        while (*pLink != nullptr) {
+            const int chunk = find_chunk(*pLink);
+            if (freeCounts[chunk] == chunks_[chunk].size) *pLink = (*pLink)->pNext;
+            else pLink = &(*pLink)->pNext;
+        }
+
+        int released = 0;
+        int kept = 0;
+        for (int i = 0; i < static_cast<int>(chunks_.size()); ++i) {
+            if (freeCounts[i] == chunks_[i].size) {
+                if (i == bumpChunk) bump_ = bumpEnd_ = nullptr;
+                released += chunks_[i].size;
+                release_chunk(chunks_[i]);
+            }
+            else {
+                chunks_[kept++] = chunks_[i];
+            }
+        }
+        chunks_.resize(static_cast<size_t>(kept));
+        capacity_ -= released;
+        return released;
+    }
+
+    template <class T, class Stats>
+    size_t block_allocator_resource<true, T, Stats>::mapped_bytes(int size) {
+        const size_t bytes = size * sizeof(node_t);
+        return (bytes + huge_page_bytes - 1) / huge_page_bytes * huge_page_bytes;
+    }
+
+    template <class T, class Stats>
+    void block_allocator_resource<true, T, Stats>::allocate_chunk(chunk_t& chunk) {
+#if defined(__linux__)
+        if (chunk.size * sizeof(node_t) >= huge_page_bytes && alignof(node_t) <= huge_page_bytes) {
+            void* ptr = mmap(nullptr, mapped_bytes(chunk.size), PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+            if (ptr == MAP_FAILED) throw std::bad_alloc{};
+            madvise(ptr, mapped_bytes(chunk.size), MADV_HUGEPAGE);
+            chunk.data = static_cast<node_t*>(ptr);
+            return;
+        }
+#endif
+        chunk.data = std::allocator<node_t>().allocate(static_cast<size_t>(chunk.size));
+    }
+
+    template <class T, class Stats>
+    void block_allocator_resource<true, T, Stats>::release_chunk(chunk_t& chunk) {
+#if defined(__linux__)
+        if (chunk.size * sizeof(node_t) >= huge_page_bytes && alignof(node_t) <= huge_page_bytes) {
+            munmap(chunk.data, mapped_bytes(chunk.size));
+            return;
+        }
+#endif
+        std::allocator<node_t>().deallocate(chunk.data, static_cast<size_t>(chunk.size));
+    }
+
 }
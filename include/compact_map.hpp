@@ -3,7 +3,11 @@
 
 #include <vector>
 #include <functional>
+#include <stdexcept>
+#include <algorithm>
+#include <cassert>
 #include <pointer_iterators.hpp>
+#include <simd_algorithms.hpp>
 
 
 namespace sc {
@@ -29,6 +33,11 @@ namespace sc {
         explicit compact_map(Allocator const& allocator = Allocator());
         explicit compact_map(Comparator const& comparator, Allocator const& allocator = Allocator());
 
+        // Builds the map from values already sorted by key, without duplicated keys (checked in debug)
+        template <class InputIt>
+        static compact_map from_sorted_unique(InputIt first, InputIt last, Comparator const& comparator = Comparator(),
+                                              Allocator const& allocator = Allocator());
+
         iterator begin() noexcept                       { return vector_.begin(); }
         iterator end()   noexcept                       { return vector_.end(); }
         const_iterator cbegin() const noexcept          { return vector_.cbegin(); }
@@ -42,11 +51,11 @@ namespace sc {
         int size() const noexcept     { return static_cast<int>(vector_.size()); }
         int capacity() const noexcept { return static_cast<int>(vector_.capacity()); }
 
-        void resize(int size)                        { vector_.resize(static_cast<uint64_t>(size)); }
-        void resize(int size, value_type const& val) { vector_.resize(static_cast<uint64_t>(size), val); }
+        void resize(int size)                        { unfreeze(); vector_.resize(static_cast<uint64_t>(size)); }
+        void resize(int size, value_type const& val) { unfreeze(); vector_.resize(static_cast<uint64_t>(size), val); }
         void reserve(int size)                       { vector_.reserve(static_cast<uint64_t>(size)); }
         void shrink_to_fit()                         { vector_.shrink_to_fit(); }
-        void clear() noexcept                        { vector_.clear(); }
+        void clear() noexcept                        { unfreeze(); vector_.clear(); }
 
         value_type* data() noexcept              { return vector_.data(); }
         value_type const* data() const noexcept  { return vector_.data(); }
@@ -64,12 +73,39 @@ namespace sc {
         const_iterator find(Key const& key) const;
 
         std::pair<iterator, bool> insert(value_type const& val);
+        // Appends, sorts then merges the values in O(N log N), the keys already in the map are kept
+        template <class InputIt>
+        void insert(InputIt first, InputIt last);
+        // Inserts the values of other whose keys are not in the map (nothing is done if other is the map)
+        void merge(compact_map const& other);
         iterator erase(iterator it);
+
+        // Builds a read optimised (Eytzinger ordered) copy of the keys used by searches, until the next modification
+        void freeze();
+        bool is_frozen() const noexcept { return frozen_; }
     private:
+        using keys_allocator_t = typename std::allocator_traits<Allocator>::template rebind_alloc<Key>;
+        using indices_allocator_t = typename std::allocator_traits<Allocator>::template rebind_alloc<int>;
+
+        // Index of the key, or -1
+        int search(Key const& key) const;
         std::pair<int, bool> dichotomy_search(Key const& key, int min, int max) const;
+        int eytzinger_search(Key const& key) const;
+        int build_eytzinger(int i, size_t k);
+        void unfreeze() noexcept;
+        // value_type can't be assigned, so the vector range functions can't be used
+        template <class InputIt>
+        void append(InputIt first, InputIt last);
+        // The map is unchanged if appending or sorting the values throws, and valid if merging them throws
+        template <class InputIt>
+        void merge_range(InputIt first, InputIt last, bool sorted);
 
         Comparator comparator_;
         std::vector<value_type, Allocator> vector_;
+        // Keys in breadth first order of the implicit search tree, from index 1, and their index in vector_
+        std::vector<Key, keys_allocator_t> eytzingerKeys_;
+        std::vector<int, indices_allocator_t> eytzingerIndices_;
+        bool frozen_;
     };
 
     template<class Key, class T, class Comparator, class Allocator>
@@ -79,9 +115,32 @@ namespace sc {
     template<class Key, class T, class Comparator, class Allocator>
     compact_map<Key, T, Comparator, Allocator>::compact_map(const Comparator &comparator, const Allocator &allocator) :
             comparator_(comparator),
-            vector_(allocator)
+            vector_(allocator),
+            eytzingerKeys_(allocator),
+            eytzingerIndices_(allocator),
+            frozen_(false)
     {}
 
+    template<class Key, class T, class Comparator, class Allocator>
+    template<class InputIt>
+    compact_map<Key, T, Comparator, Allocator> compact_map<Key, T, Comparator, Allocator>::from_sorted_unique(
+            InputIt first, InputIt last, const Comparator &comparator, const Allocator &allocator) {
+        compact_map map(comparator, allocator);
+        map.append(first, last);
+        assert(std::adjacent_find(map.vector_.cbegin(), map.vector_.cend(), [&comparator] (value_type const& v1, value_type const& v2) {
+            return !comparator(v1.first, v2.first);
+        }) == map.vector_.cend() && "Values must be sorted by unique keys");
+        return map;
+    }
+
+    template<class Key, class T, class Comparator, class Allocator>
+    int compact_map<Key, T, Comparator, Allocator>::search(const Key &key) const {
+        if (frozen_) return eytzinger_search(key);
+
+        const auto pair = dichotomy_search(key, 0, size());
+        return pair.second ? pair.first : -1;
+    }
+
     template<class Key, class T, class Comparator, class Allocator>
     std::pair<int, bool> compact_map<Key, T, Comparator, Allocator>::dichotomy_search(const Key &key, int min, int max) const {
         const int diff = max - min;
@@ -97,24 +156,74 @@ namespace sc {
             return { middle, true };
     }
 
+    template<class Key, class T, class Comparator, class Allocator>
+    int compact_map<Key, T, Comparator, Allocator>::eytzinger_search(const Key &key) const {
+        const auto size_ = static_cast<size_t>(size());
+        Key const* const keys = eytzingerKeys_.data();
+
+        // Goes down to a leaf, then back to the last node where the search went left : the lower bound.
+        // Indices are computed in size_t, the last level of a large map is above the int range.
+        size_t k = 1;
+        while (k <= size_) {
+#if defined(__clang__) || defined(__GNUG__)
+            // The 16 descendants 4 levels below are contiguous, prefetched only when they are in the array
+            if (16 * k < size_) __builtin_prefetch(keys + 16 * k);
+#endif
+            k = 2 * k + static_cast<size_t>(comparator_(keys[k], key));
+        }
+        while (k & 1) k >>= 1;
+        k >>= 1;
+
+        if (k == 0 || comparator_(key, keys[k])) return -1;
+        return eytzingerIndices_[k];
+    }
+
+    template<class Key, class T, class Comparator, class Allocator>
+    int compact_map<Key, T, Comparator, Allocator>::build_eytzinger(int i, size_t k) {
+        if (k <= static_cast<size_t>(size())) {
+            // In-order traversal of the implicit tree follows the sorted order
+            i = build_eytzinger(i, 2 * k);
+            eytzingerKeys_[k] = vector_[i].first;
+            eytzingerIndices_[k] = i;
+            i = build_eytzinger(i + 1, 2 * k + 1);
+        }
+        return i;
+    }
+
+    template<class Key, class T, class Comparator, class Allocator>
+    void compact_map<Key, T, Comparator, Allocator>::freeze() {
+        eytzingerKeys_.resize(vector_.size() + 1);
+        eytzingerIndices_.resize(vector_.size() + 1);
+        build_eytzinger(0, 1);
+        frozen_ = true;
+    }
+
+    template<class Key, class T, class Comparator, class Allocator>
+    void compact_map<Key, T, Comparator, Allocator>::unfreeze() noexcept {
+        if (!frozen_) return;
+        eytzingerKeys_.clear();
+        eytzingerIndices_.clear();
+        frozen_ = false;
+    }
+
     template<class Key, class T, class Comparator, class Allocator>
     typename compact_map<Key, T, Comparator, Allocator>::iterator
     compact_map<Key, T, Comparator, Allocator>::find(const Key &key) {
-        const auto pair = dichotomy_search(key, 0, size());
-        return pair.second ? begin() + pair.first : end();
+        const int i = search(key);
+        return i != -1 ? begin() + i : end();
     }
 
     template<class Key, class T, class Comparator, class Allocator>
     typename compact_map<Key, T, Comparator, Allocator>::const_iterator
     compact_map<Key, T, Comparator, Allocator>::find(const Key &key) const {
-        const auto pair = dichotomy_search(key, 0, size());
-        return pair.second ? cbegin() + pair.first : cend();
+        const int i = search(key);
+        return i != -1 ? cbegin() + i : cend();
     }
 
     template<class Key, class T, class Comparator, class Allocator>
     T& compact_map<Key, T, Comparator, Allocator>::operator[](const Key &key) {
-        const auto pair = dichotomy_search(key, 0, size());
-        if (pair.second) return vector_[pair.first].second;
+        const int i = search(key);
+        if (i != -1) return vector_[i].second;
 
         const auto itPair = insert({ key, {} });
         return itPair.first->second;
@@ -122,13 +231,13 @@ namespace sc {
 
     template<class Key, class T, class Comparator, class Allocator>
     T &compact_map<Key, T, Comparator, Allocator>::at(const Key &key) {
-        return const_cast<compact_map const*>(this)->at(key);
+        return const_cast<T&>(const_cast<compact_map const*>(this)->at(key));
     }
 
     template<class Key, class T, class Comparator, class Allocator>
     T const &compact_map<Key, T, Comparator, Allocator>::at(const Key &key) const {
-        const auto pair = dichotomy_search(key, 0, size());
-        if (pair.second) return vector_[pair.first].first;
+        const int i = search(key);
+        if (i != -1) return vector_[i].second;
         throw std::out_of_range("Key not found in compact_map");
     }
 
@@ -138,8 +247,9 @@ namespace sc {
         const auto pair = dichotomy_search(val.first, 0, size());
         if (pair.second) return { begin() + pair.first, false };
 
-        const int position = comparator_(vector_[pair.first].first, val.first) ?
-             pair.first + 1 : pair.first;
+        unfreeze();
+        // The search ends on the insertion position
+        const int position = pair.first;
 
         int i = size();
         vector_.emplace_back();
@@ -150,9 +260,68 @@ namespace sc {
         return { begin() + position, true };
     }
 
+    template<class Key, class T, class Comparator, class Allocator>
+    template<class InputIt>
+    void compact_map<Key, T, Comparator, Allocator>::insert(InputIt first, InputIt last) {
+        merge_range(first, last, false);
+    }
+
+    template<class Key, class T, class Comparator, class Allocator>
+    void compact_map<Key, T, Comparator, Allocator>::merge(compact_map const& other) {
+        // Appending to the map would invalidate the iterators on other
+        if (&other == this) return;
+        merge_range(other.vector_.cbegin(), other.vector_.cend(), true);
+    }
+
+    template<class Key, class T, class Comparator, class Allocator>
+    template<class InputIt>
+    void compact_map<Key, T, Comparator, Allocator>::append(InputIt first, InputIt last) {
+        if constexpr (std::is_base_of_v<std::forward_iterator_tag, typename std::iterator_traits<InputIt>::iterator_category>) {
+            const size_t required = vector_.size() + static_cast<size_t>(std::distance(first, last));
+            if (required > vector_.capacity()) {
+                vector_.reserve(std::max(required, 2 * vector_.capacity()));
+            }
+        }
+        for (; first != last; ++first) {
+            vector_.emplace_back(*first);
+        }
+    }
+
+    template<class Key, class T, class Comparator, class Allocator>
+    template<class InputIt>
+    void compact_map<Key, T, Comparator, Allocator>::merge_range(InputIt first, InputIt last, bool sorted) {
+        const int oldSize = size();
+        const auto less = [this] (mut_value_type const& v1, mut_value_type const& v2) {
+            return comparator_(v1.first, v2.first);
+        };
+        // Stable algorithms keep the values already in the map, then the first appended ones, before duplicates.
+        // The values already in the map are not touched until the merge.
+        try {
+            append(first, last);
+            if (!sorted) {
+                mut_value_type* const data = reinterpret_cast<mut_value_type*>(vector_.data());
+                std::stable_sort(data + oldSize, data + size(), less);
+            }
+        }
+        catch (...) {
+            vector_.resize(static_cast<uint64_t>(oldSize));
+            throw;
+        }
+        if (oldSize == size()) return;
+        unfreeze();
+
+        mut_value_type* const data = reinterpret_cast<mut_value_type*>(vector_.data());
+        std::inplace_merge(data, data + oldSize, data + size(), less);
+        mut_value_type* const end = std::unique(data, data + size(), [&less] (mut_value_type const& v1, mut_value_type const& v2) {
+            return !less(v1, v2);
+        });
+        vector_.resize(static_cast<uint64_t>(end - data));
+    }
+
     template<class Key, class T, class Comparator, class Allocator>
     typename compact_map<Key, T, Comparator, Allocator>::iterator
     compact_map<Key, T, Comparator, Allocator>::erase(iterator it) {
+        unfreeze();
         auto i = static_cast<int>(it - begin());
         const int size_ = size();
         while (++i != size_) {
@@ -162,4 +331,281 @@ namespace sc {
         return it;
     }
 
+    /// compact_map storing the keys and the values in two arrays : searches only touch the keys cache lines,
+    /// and integer keys (with std::less) are compared with SIMD once the binary search is narrow enough.
+    /// Iterators dereference to pairs of references.
+
+    template <
+            class Key,
+            class T,
+            class Comparator = std::less<Key>,
+            class Allocator = std::allocator<std::pair<const Key, T>>
+    >
+    class split_compact_map {
+        using keys_allocator_t = typename std::allocator_traits<Allocator>::template rebind_alloc<Key>;
+        using values_allocator_t = typename std::allocator_traits<Allocator>::template rebind_alloc<T>;
+
+        template <bool CONST>
+        class iterator_t {
+            friend split_compact_map;
+            using map_t = std::conditional_t<CONST, split_compact_map const, split_compact_map>;
+            using mapped_ref_t = std::conditional_t<CONST, T const&, T&>;
+
+            map_t* map_;
+            int i_;
+            iterator_t(map_t* map, int i) noexcept : map_(map), i_(i) {}
+        public:
+            using value_type = std::pair<const Key, T>;
+            using reference = std::pair<Key const&, mapped_ref_t>;
+            using difference_type = ptrdiff_t;
+            // Proxy iterator : the reference is a pair of references built on the fly, so the standard algorithms
+            // only see an input iterator. The random access operators are still available.
+            using iterator_category = std::input_iterator_tag;
+            struct pointer {
+                reference ref;
+                reference* operator->() noexcept { return &ref; }
+            };
+
+            iterator_t() noexcept : map_(nullptr), i_(0) {}
+            // Conversion from iterator to const_iterator
+            template <bool OTHER_CONST, class = std::enable_if_t<CONST && !OTHER_CONST>>
+            iterator_t(iterator_t<OTHER_CONST> const& it) noexcept : map_(it.map_), i_(it.i_) {}
+
+            Key const& key() const noexcept     { return map_->keys_[i_]; }
+            mapped_ref_t value() const noexcept { return map_->values_[i_]; }
+
+            reference operator*() const noexcept  { return { key(), value() }; }
+            pointer operator->() const noexcept   { return { **this }; }
+            reference operator[](int shift) const { return *(*this + shift); }
+
+            bool operator==(iterator_t it) const noexcept { return i_ == it.i_; }
+            bool operator!=(iterator_t it) const noexcept { return i_ != it.i_; }
+            bool operator<(iterator_t it) const noexcept  { return i_ < it.i_; }
+            bool operator>(iterator_t it) const noexcept  { return i_ > it.i_; }
+            bool operator<=(iterator_t it) const noexcept { return i_ <= it.i_; }
+            bool operator>=(iterator_t it) const noexcept { return i_ >= it.i_; }
+
+            iterator_t& operator++() noexcept             { ++i_; return *this; }
+            iterator_t& operator--() noexcept             { --i_; return *this; }
+            iterator_t  operator++(int) noexcept          { return { map_, i_++ }; }
+            iterator_t  operator--(int) noexcept          { return { map_, i_-- }; }
+            iterator_t& operator+=(int shift) noexcept    { i_ += shift; return *this; }
+            iterator_t& operator-=(int shift) noexcept    { i_ -= shift; return *this; }
+            iterator_t  operator+(int shift) const noexcept { return { map_, i_ + shift }; }
+            iterator_t  operator-(int shift) const noexcept { return { map_, i_ - shift }; }
+
+            difference_type operator-(iterator_t it) const noexcept { return i_ - it.i_; }
+        };
+
+        // Keys count under which the search ends with a SIMD comparison
+        static constexpr int simd_window = 32;
+        static constexpr bool simd_keys = std::is_integral_v<Key> && !std::is_same_v<Key, bool> &&
+                                          std::is_same_v<Comparator, std::less<Key>>;
+    public:
+        using key_type    = Key;
+        using mapped_type = T;
+        using value_type  = std::pair<const Key, T>;
+
+        using iterator       = iterator_t<false>;
+        using const_iterator = iterator_t<true>;
+
+        explicit split_compact_map(Allocator const& allocator = Allocator());
+        explicit split_compact_map(Comparator const& comparator, Allocator const& allocator = Allocator());
+
+        iterator begin() noexcept              { return { this, 0 }; }
+        iterator end()   noexcept              { return { this, size() }; }
+        const_iterator cbegin() const noexcept { return { this, 0 }; }
+        const_iterator cend()   const noexcept { return { this, size() }; }
+
+        bool empty() const noexcept   { return keys_.empty(); }
+        int size() const noexcept     { return static_cast<int>(keys_.size()); }
+        int capacity() const noexcept { return static_cast<int>(keys_.capacity()); }
+
+        void reserve(int size)        { keys_.reserve(static_cast<uint64_t>(size)); values_.reserve(static_cast<uint64_t>(size)); }
+        void shrink_to_fit()          { keys_.shrink_to_fit(); values_.shrink_to_fit(); }
+        void clear() noexcept         { keys_.clear(); values_.clear(); }
+
+        Key const* keys() const noexcept { return keys_.data(); }
+        T* values() noexcept             { return values_.data(); }
+        T const* values() const noexcept { return values_.data(); }
+
+        T& operator[](Key const& key);
+        T& at(Key const& key);
+        T const& at(Key const& key) const;
+        iterator find(Key const& key);
+        const_iterator find(Key const& key) const;
+
+        std::pair<iterator, bool> insert(value_type const& val) { return insert_value(val); }
+        std::pair<iterator, bool> insert(value_type&& val)      { return insert_value(std::move(val)); }
+        // Pairs convertible to value_type
+        template <class Pair>
+        std::pair<iterator, bool> insert(Pair&& val)            { return insert_value(std::forward<Pair>(val)); }
+        // Sorts then merges the values in O(N log N), the keys already in the map are kept.
+        // The map is unchanged if an exception is thrown.
+        template <class InputIt>
+        void insert(InputIt first, InputIt last);
+        iterator erase(const_iterator it);
+    private:
+        // Index of the key, or -1
+        int search(Key const& key) const;
+        int lower_bound(Key const& key) const;
+        // The key is removed if inserting the value throws
+        template <class Value>
+        std::pair<iterator, bool> insert_value(Value&& val);
+
+        Comparator comparator_;
+        std::vector<Key, keys_allocator_t> keys_;
+        std::vector<T, values_allocator_t> values_;
+    };
+
+    template<class Key, class T, class Comparator, class Allocator>
+    split_compact_map<Key, T, Comparator, Allocator>::split_compact_map(const Allocator &allocator) :
+            split_compact_map(Comparator(), allocator) {}
+
+    template<class Key, class T, class Comparator, class Allocator>
+    split_compact_map<Key, T, Comparator, Allocator>::split_compact_map(const Comparator &comparator, const Allocator &allocator) :
+            comparator_(comparator),
+            keys_(keys_allocator_t(allocator)),
+            values_(values_allocator_t(allocator))
+    {}
+
+    template<class Key, class T, class Comparator, class Allocator>
+    int split_compact_map<Key, T, Comparator, Allocator>::lower_bound(const Key &key) const {
+        return static_cast<int>(std::lower_bound(keys_.cbegin(), keys_.cend(), key, comparator_) - keys_.cbegin());
+    }
+
+    template<class Key, class T, class Comparator, class Allocator>
+    int split_compact_map<Key, T, Comparator, Allocator>::search(const Key &key) const {
+        if constexpr (simd_keys) {
+            // The lower bound stays in [min, max]
+            int min = 0;
+            int max = size();
+            while (max - min > simd_window) {
+                const int middle = min + (max - min) / 2;
+                if (keys_[middle] < key) min = middle + 1;
+                else max = middle;
+            }
+            const int i = simd::find(keys_.data() + min, std::min(max + 1, size()) - min, key);
+            return i == -1 ? -1 : min + i;
+        }
+        else {
+            const int i = lower_bound(key);
+            return i != size() && !comparator_(key, keys_[i]) ? i : -1;
+        }
+    }
+
+    template<class Key, class T, class Comparator, class Allocator>
+    typename split_compact_map<Key, T, Comparator, Allocator>::iterator
+    split_compact_map<Key, T, Comparator, Allocator>::find(const Key &key) {
+        const int i = search(key);
+        return i != -1 ? iterator{ this, i } : end();
+    }
+
+    template<class Key, class T, class Comparator, class Allocator>
+    typename split_compact_map<Key, T, Comparator, Allocator>::const_iterator
+    split_compact_map<Key, T, Comparator, Allocator>::find(const Key &key) const {
+        const int i = search(key);
+        return i != -1 ? const_iterator{ this, i } : cend();
+    }
+
+    template<class Key, class T, class Comparator, class Allocator>
+    T& split_compact_map<Key, T, Comparator, Allocator>::operator[](const Key &key) {
+        const int i = search(key);
+        if (i != -1) return values_[i];
+
+        return insert(value_type{ key, {} }).first.value();
+    }
+
+    template<class Key, class T, class Comparator, class Allocator>
+    T &split_compact_map<Key, T, Comparator, Allocator>::at(const Key &key) {
+        return const_cast<T&>(const_cast<split_compact_map const*>(this)->at(key));
+    }
+
+    template<class Key, class T, class Comparator, class Allocator>
+    T const &split_compact_map<Key, T, Comparator, Allocator>::at(const Key &key) const {
+        const int i = search(key);
+        if (i != -1) return values_[i];
+        throw std::out_of_range("Key not found in split_compact_map");
+    }
+
+    template<class Key, class T, class Comparator, class Allocator>
+    template<class Value>
+    std::pair<typename split_compact_map<Key, T, Comparator, Allocator>::iterator, bool>
+    split_compact_map<Key, T, Comparator, Allocator>::insert_value(Value&& val) {
+        const int i = lower_bound(val.first);
+        if (i != size() && !comparator_(val.first, keys_[i])) return { iterator{ this, i }, false };
+
+        keys_.insert(keys_.begin() + i, std::forward<Value>(val).first);
+        try {
+            values_.insert(values_.begin() + i, std::forward<Value>(val).second);
+        }
+        catch (...) {
+            keys_.erase(keys_.begin() + i);
+            throw;
+        }
+        return { iterator{ this, i }, true };
+    }
+
+    template<class Key, class T, class Comparator, class Allocator>
+    template<class InputIt>
+    void split_compact_map<Key, T, Comparator, Allocator>::insert(InputIt first, InputIt last) {
+        std::vector<std::pair<Key, T>> added(first, last);
+        if (added.empty()) return;
+
+        // Stable, so the first of duplicated keys is kept
+        std::stable_sort(added.begin(), added.end(), [this] (auto const& v1, auto const& v2) {
+            return comparator_(v1.first, v2.first);
+        });
+
+        // Merges the two sorted ranges, the values already in the map first for equal keys.
+        // The order is computed before touching the map, so a throwing comparator leaves it unchanged.
+        // Kept old entries are indices >= 0, added ones are ~index.
+        std::vector<int> merged;
+        merged.reserve(keys_.size() + added.size());
+        Key const* lastKey = nullptr;
+        size_t i = 0;
+        size_t j = 0;
+        while (i != keys_.size() || j != added.size()) {
+            const bool takeOld = j == added.size() || (i != keys_.size() && !comparator_(added[j].first, keys_[i]));
+            Key const& key = takeOld ? keys_[i] : added[j].first;
+            if (lastKey == nullptr || comparator_(*lastKey, key)) {
+                merged.push_back(takeOld ? static_cast<int>(i) : ~static_cast<int>(j));
+                lastKey = &key;
+            }
+            takeOld ? ++i : ++j;
+        }
+
+        // The map entries are moved only if no move can throw, otherwise they are copied and the map is unchanged
+        // until the new arrays replace it
+        constexpr bool moveOld = std::is_nothrow_move_constructible_v<Key> && std::is_nothrow_move_constructible_v<T>;
+        std::vector<Key, keys_allocator_t> keys(keys_.get_allocator());
+        std::vector<T, values_allocator_t> values(values_.get_allocator());
+        keys.reserve(merged.size());
+        values.reserve(merged.size());
+        for (int index : merged) {
+            if (index < 0) {
+                keys.push_back(std::move(added[~index].first));
+                values.push_back(std::move(added[~index].second));
+            }
+            else if constexpr (moveOld) {
+                keys.push_back(std::move(keys_[index]));
+                values.push_back(std::move(values_[index]));
+            }
+            else {
+                keys.push_back(keys_[index]);
+                values.push_back(values_[index]);
+            }
+        }
+        keys_.swap(keys);
+        values_.swap(values);
+    }
+
+    template<class Key, class T, class Comparator, class Allocator>
+    typename split_compact_map<Key, T, Comparator, Allocator>::iterator
+    split_compact_map<Key, T, Comparator, Allocator>::erase(const_iterator it) {
+        keys_.erase(keys_.begin() + it.i_);
+        values_.erase(values_.begin() + it.i_);
+        return { this, it.i_ };
+    }
+
 }
@@ -0,0 +1,269 @@
+#pragma once
+
+#include <string>
+#include <cerrno>
+#include <cassert>
+#include <cstdint>
+#include <limits>
+#include <system_error>
+#include <type_traits>
+#include "pointer_iterators.hpp"
+#include "flag_enums.hpp"
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+
+namespace sc {
+
+    enum class map_mode {
+        read_only,
+        read_write  // Modifications are shared with the file, and flushed by sync or by the OS
+    };
+
+    // Kernel hints, can be combined with sc::flag_operators
+    enum class map_hints : uint32_t {
+        none =       0u,
+        populate =   1u << 0,   // Reads all the pages at mapping (Linux only)
+        sequential = 1u << 1,
+        random =     1u << 2,
+        will_need =  1u << 3,
+        huge_pages = 1u << 4    // Linux only
+    };
+
+    /// Array of POD values stored in a file mapped in memory : opening it is a mapping call instead of a full
+    /// read, and the pages are shared with the other processes mapping the file. Trailing bytes of the file not
+    /// forming a full value are ignored.
+
+    template <class T>
+    class mapped_pod_vector {
+        static_assert(std::is_trivially_copyable_v<T>, "Values are read from the file bytes");
+    public:
+        using value_type = T;
+        using size_type = int;
+
+        using iterator = pointer_iterator<mapped_pod_vector, T>;
+        using const_iterator = const_pointer_iterator<mapped_pod_vector, T>;
+        using reverse_iterator = reverse_pointer_iterator<mapped_pod_vector, T>;
+        using const_reverse_iterator = const_reverse_pointer_iterator<mapped_pod_vector, T>;
+
+        mapped_pod_vector() noexcept;
+        // The file is created when opened in read_write mode
+        explicit mapped_pod_vector(std::string const& path, map_mode mode = map_mode::read_only,
+                                   map_hints hints = map_hints::none);
+        ~mapped_pod_vector() noexcept;
+
+        mapped_pod_vector(mapped_pod_vector const&) = delete;
+        mapped_pod_vector& operator=(mapped_pod_vector const&) = delete;
+        mapped_pod_vector(mapped_pod_vector&& moved) noexcept;
+        mapped_pod_vector& operator=(mapped_pod_vector&& moved) noexcept;
+
+        // Resizes the file, new values are zeroed (read_write mode only)
+        void resize(int size);
+        // Flushes the modifications to the file (read_write mode only)
+        void sync(bool async = false);
+        void close() noexcept;
+
+        bool is_open() const  { return fd_ != -1; }
+        map_mode mode() const { return mode_; }
+        int size() const      { return size_; }
+        bool empty() const    { return size_ == 0; }
+
+        // Values must not be modified in read_only mode
+        T* data()                        { return data_; }
+        T const* data() const            { return data_; }
+        T& operator[](int i)             { return data_[i]; }
+        T const& operator[](int i) const { return data_[i]; }
+        T& front()                       { return data_[0]; }
+        T const& front() const           { return data_[0]; }
+        T& back()                        { return data_[size_ - 1]; }
+        T const& back() const            { return data_[size_ - 1]; }
+
+        iterator begin()                       { return iterator(data_); }
+        iterator end()                         { return iterator(data_ + size_); }
+        const_iterator cbegin() const          { return const_iterator(data_); }
+        const_iterator cend() const            { return const_iterator(data_ + size_); }
+        reverse_iterator rbegin()              { return reverse_iterator(data_ + size_ - 1); }
+        reverse_iterator rend()                { return reverse_iterator(data_ - 1); }
+        const_reverse_iterator crbegin() const { return const_reverse_iterator(data_ + size_ - 1); }
+        const_reverse_iterator crend() const   { return const_reverse_iterator(data_ - 1); }
+    private:
+        static size_t bytes_of(int size) { return static_cast<size_t>(size) * sizeof(T); }
+        // Throws if the values count doesn't fit in an int
+        static int checked_size(uint64_t count);
+
+        void map(size_t bytes);
+        void advise(size_t bytes) noexcept;
+        [[noreturn]] static void throw_errno(char const* what);
+
+        int fd_;
+        int size_;
+        T* data_;
+        map_mode mode_;
+        map_hints hints_;
+    };
+
+    // ______________
+    // Implementation
+
+    template <class T>
+    mapped_pod_vector<T>::mapped_pod_vector() noexcept :
+            fd_(-1),
+            size_(0),
+            data_(nullptr),
+            mode_(map_mode::read_only),
+            hints_(map_hints::none)
+    {}
+
+    template <class T>
+    mapped_pod_vector<T>::mapped_pod_vector(std::string const& path, map_mode mode, map_hints hints) :
+            fd_(-1),
+            size_(0),
+            data_(nullptr),
+            mode_(mode),
+            hints_(hints)
+    {
+        fd_ = mode == map_mode::read_only ? ::open(path.c_str(), O_RDONLY) : ::open(path.c_str(), O_RDWR | O_CREAT, 0644);
+        if (fd_ == -1) throw_errno("mapped_pod_vector can't open the file");
+
+        struct stat stats{};
+        if (::fstat(fd_, &stats) == -1) {
+            const int error = errno;
+            close();
+            throw std::system_error(error, std::generic_category(), "mapped_pod_vector can't stat the file");
+        }
+        try {
+            size_ = checked_size(static_cast<uint64_t>(stats.st_size) / sizeof(T));
+            map(bytes_of(size_));
+        }
+        catch (...) {
+            close();
+            throw;
+        }
+    }
+
+    template <class T>
+    mapped_pod_vector<T>::~mapped_pod_vector() noexcept {
+        close();
+    }
+
+    template <class T>
+    mapped_pod_vector<T>::mapped_pod_vector(mapped_pod_vector&& moved) noexcept :
+            fd_(moved.fd_),
+            size_(moved.size_),
+            data_(moved.data_),
+            mode_(moved.mode_),
+            hints_(moved.hints_)
+    {
+        moved.fd_ = -1;
+        moved.size_ = 0;
+        moved.data_ = nullptr;
+    }
+
+    template <class T>
+    mapped_pod_vector<T>& mapped_pod_vector<T>::operator=(mapped_pod_vector&& moved) noexcept {
+        if (this != &moved) {
+            close();
+            fd_ = moved.fd_;
+            size_ = moved.size_;
+            data_ = moved.data_;
+            mode_ = moved.mode_;
+            hints_ = moved.hints_;
+            moved.fd_ = -1;
+            moved.size_ = 0;
+            moved.data_ = nullptr;
+        }
+        return *this;
+    }
+
+    template <class T>
+    void mapped_pod_vector<T>::resize(int size) {
+        assert(is_open() && mode_ == map_mode::read_write);
+        if (size < 0) throw std::system_error(EINVAL, std::generic_category(), "mapped_pod_vector can't have a negative size");
+        if (size == size_) return;
+
+        if (::ftruncate(fd_, static_cast<off_t>(bytes_of(size))) == -1) throw_errno("mapped_pod_vector can't resize the file");
+#if defined(__linux__)
+        if (data_ != nullptr && size > 0) {
+            void* ptr = ::mremap(data_, bytes_of(size_), bytes_of(size), MREMAP_MAYMOVE);
+            if (ptr == MAP_FAILED) throw_errno("mapped_pod_vector can't remap the file");
+            data_ = static_cast<T*>(ptr);
+            size_ = size;
+            advise(bytes_of(size_));
+            return;
+        }
+#endif
+        if (data_ != nullptr) {
+            ::munmap(data_, bytes_of(size_));
+            data_ = nullptr;
+        }
+        size_ = size;
+        map(bytes_of(size_));
+    }
+
+    template <class T>
+    void mapped_pod_vector<T>::sync(bool async) {
+        assert(is_open() && mode_ == map_mode::read_write);
+        if (data_ == nullptr) return;
+
+        if (::msync(data_, bytes_of(size_), async ? MS_ASYNC : MS_SYNC) == -1) throw_errno("mapped_pod_vector can't sync the file");
+    }
+
+    template <class T>
+    void mapped_pod_vector<T>::close() noexcept {
+        if (data_ != nullptr) {
+            ::munmap(data_, bytes_of(size_));
+            data_ = nullptr;
+        }
+        if (fd_ != -1) {
+            ::close(fd_);
+            fd_ = -1;
+        }
+        size_ = 0;
+    }
+
+    template <class T>
+    void mapped_pod_vector<T>::map(size_t bytes) {
+        // Empty files can't be mapped
+        if (bytes == 0) return;
+
+        using namespace flag_operators;
+        const int protection = mode_ == map_mode::read_only ? PROT_READ : PROT_READ | PROT_WRITE;
+        int flags = MAP_SHARED;
+#if defined(__linux__)
+        if ((hints_ & map_hints::populate) != map_hints::none) flags |= MAP_POPULATE;
+#endif
+        void* ptr = ::mmap(nullptr, bytes, protection, flags, fd_, 0);
+        if (ptr == MAP_FAILED) throw_errno("mapped_pod_vector can't map the file");
+        data_ = static_cast<T*>(ptr);
+        advise(bytes);
+    }
+
+    template <class T>
+    void mapped_pod_vector<T>::advise(size_t bytes) noexcept {
+        using namespace flag_operators;
+        // Hints only, failures are ignored
+        if ((hints_ & map_hints::sequential) != map_hints::none) ::madvise(data_, bytes, MADV_SEQUENTIAL);
+        if ((hints_ & map_hints::random) != map_hints::none)     ::madvise(data_, bytes, MADV_RANDOM);
+        if ((hints_ & map_hints::will_need) != map_hints::none)  ::madvise(data_, bytes, MADV_WILLNEED);
+#if defined(__linux__)
+        if ((hints_ & map_hints::huge_pages) != map_hints::none) ::madvise(data_, bytes, MADV_HUGEPAGE);
+#endif
+    }
+
+    template <class T>
+    int mapped_pod_vector<T>::checked_size(uint64_t count) {
+        if (count > static_cast<uint64_t>(std::numeric_limits<int>::max())) {
+            throw std::system_error(EOVERFLOW, std::generic_category(), "mapped_pod_vector file has too many values");
+        }
+        return static_cast<int>(count);
+    }
+
+    template <class T>
+    void mapped_pod_vector<T>::throw_errno(char const* what) {
+        throw std::system_error(errno, std::generic_category(), what);
+    }
+
+}
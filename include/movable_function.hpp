@@ -1,39 +1,98 @@
-
 #pragma once
 
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <cstring>
+#include "type_traits.hpp"
+
 
 namespace sc {
 
-    // TODO Align data with F, custom allocator, look for inline data
+    /// Callables up to INLINE_SIZE bytes (and nothrow movable) are stored inline, the others are allocated
+    /// with the given allocator (std::allocator by default), which is stored with them.
 
-    template <class> class movable_function;
+    template <class, size_t INLINE_SIZE = 3 * sizeof(void*)> class movable_function;
 
-    template <class Res, class...Args>
-    class movable_function<Res(Args...)> {
+    template <class Res, class...Args, size_t INLINE_SIZE>
+    class movable_function<Res(Args...), INLINE_SIZE> {
+        static_assert(INLINE_SIZE >= sizeof(void*), "The inline storage must be able to store a pointer");
+
+        using storage_t =     std::aligned_storage_t<INLINE_SIZE, alignof(void*)>;
         using fun_t =         Res  (*) (Args...);
-        using destroy_f_t =   void (*) (char* f);
-        using invoke_f_t =    Res  (*) (char* f, Args&&...args);
+        using invoke_f_t =    Res  (*) (storage_t& f, Args&&...args);
+        using move_f_t =      void (*) (storage_t& dst, storage_t& src) noexcept;
+        using destroy_f_t =   void (*) (storage_t& f) noexcept;
+
+        template <class F>
+        static constexpr bool is_inline =
+                sizeof(F) <= sizeof(storage_t) &&
+                alignof(F) <= alignof(storage_t) &&
+                std::is_nothrow_move_constructible_v<F>;
+
+        // Allocated callable, with its allocator as base for empty base optimization
+        template <class F, class Alloc>
+        struct box_t : std::allocator_traits<Alloc>::template rebind_alloc<box_t<F, Alloc>> {
+            using allocator_t = typename std::allocator_traits<Alloc>::template rebind_alloc<box_t>;
+
+            box_t(allocator_t const& allocator, F&& f) : allocator_t(allocator), f(std::move(f)) {}
+            F f;
+        };
 
-        template <typename F>
-        static Res invoke_f(F* f, Args&&... args) {
-            return (*f)(std::forward<Args>(args)...);
+        // Inline callables ignore the allocator
+        template <class F, class Alloc>
+        using allocator_key_t = std::conditional_t<is_inline<F>, std::allocator<F>, Alloc>;
+
+        template <class F, class Alloc>
+        static F& get(storage_t& storage) noexcept {
+            if constexpr (is_inline<F>) return *std::launder(reinterpret_cast<F*>(&storage));
+            else return (*reinterpret_cast<box_t<F, Alloc>**>(&storage))->f;
+        }
+
+        template <class F, class Alloc>
+        static Res invoke_f(storage_t& f, Args&&... args) {
+            return get<F, Alloc>(f)(std::forward<Args>(args)...);
         }
-        template <typename F>
-        static void destroy_f(F* f) {
-            f->~F();
-            std::allocator<F>().deallocate(f, 1);
+        // Move the inline callable from src to dst and destroy src
+        template <class F, class Alloc>
+        static void move_f(storage_t& dst, storage_t& src) noexcept {
+            new (&dst) F(std::move(get<F, Alloc>(src)));
+            get<F, Alloc>(src).~F();
+        }
+        template <class F, class Alloc>
+        static void destroy_f(storage_t& f) noexcept {
+            if constexpr (is_inline<F>) {
+                get<F, Alloc>(f).~F();
+            }
+            else {
+                using box_allocator_t = typename box_t<F, Alloc>::allocator_t;
+                box_t<F, Alloc>* const box = *reinterpret_cast<box_t<F, Alloc>**>(&f);
+                box_allocator_t allocator = *box;
+                box->~box_t();
+                std::allocator_traits<box_allocator_t>::deallocate(allocator, box, 1);
+            }
         }
 
-        static Res invoke_fun(char* f, Args&&...args) {
-            return reinterpret_cast<fun_t>(f)(std::forward<Args>(args)...);
+        // One static table per stored type, so the wrapper is only a pointer and the inline storage
+        struct vtable_t {
+            invoke_f_t invoke;
+            move_f_t move;
+            destroy_f_t destroy;
+        };
+        // Boxed and trivially relocatable inline callables are moved with a memcpy of the storage (null move)
+        template <class F, class Alloc>
+        static constexpr move_f_t move_function() noexcept {
+            if constexpr (!is_inline<F> || is_trivially_relocatable<F>) return nullptr;
+            else return move_f<F, Alloc>;
         }
-        static void destroy_fun(char* f) {}
+        template <class F, class Alloc>
+        static constexpr vtable_t vtable = { invoke_f<F, Alloc>, move_function<F, Alloc>(), destroy_f<F, Alloc> };
 
     public:
+        static constexpr size_t inline_size = INLINE_SIZE;
+
         movable_function() noexcept :
-                invoke_f_(nullptr),
-                destroy_f_(nullptr),
-                data_(nullptr)
+                vtable_(nullptr)
         {}
 
         ~movable_function() noexcept {
@@ -45,44 +104,61 @@ namespace sc {
                 !std::is_lvalue_reference_v<F>
         >>
         movable_function(F&& f) :
-                invoke_f_ (reinterpret_cast<invoke_f_t>(invoke_f<F>)),
-                destroy_f_(reinterpret_cast<destroy_f_t>(destroy_f<F>)),
-                data_(reinterpret_cast<char*>(std::allocator<F>().allocate(1)))
+                movable_function(std::allocator_arg, std::allocator<F>(), std::move(f))
+        {}
+        template <class Alloc, class F, class = std::enable_if_t<
+                !std::is_pointer_v<F> &&
+                !std::is_lvalue_reference_v<F>
+        >>
+        movable_function(std::allocator_arg_t, Alloc const& allocator, F&& f) :
+                vtable_(&vtable<F, allocator_key_t<F, Alloc>>)
         {
-            new (reinterpret_cast<F*>(data_)) F(std::move(f));
+            if constexpr (is_inline<F>) {
+                new (&storage_) F(std::move(f));
+            }
+            else {
+                using box_allocator_t = typename box_t<F, Alloc>::allocator_t;
+                box_allocator_t boxAllocator(allocator);
+                box_t<F, Alloc>* const box = std::allocator_traits<box_allocator_t>::allocate(boxAllocator, 1);
+                try {
+                    new (box) box_t<F, Alloc>(boxAllocator, std::move(f));
+                }
+                catch (...) {
+                    std::allocator_traits<box_allocator_t>::deallocate(boxAllocator, box, 1);
+                    throw;
+                }
+                *reinterpret_cast<box_t<F, Alloc>**>(&storage_) = box;
+            }
         }
+        // A null function pointer gives an invalid function
         movable_function(fun_t f) :
-                invoke_f_ (invoke_fun),
-                destroy_f_(destroy_fun),
-                data_(reinterpret_cast<char*>(f))
+                vtable_(f != nullptr ? &vtable<fun_t, std::allocator<fun_t>> : nullptr)
         {
-            *reinterpret_cast<fun_t*>(&data_) = f;
+            new (&storage_) fun_t(f);
         }
 
         movable_function(movable_function const&) = delete;
         movable_function(movable_function&& f) noexcept :
-                invoke_f_(f.invoke_f_),
-                destroy_f_(f.destroy_f_),
-                data_(f.data_)
+                movable_function()
         {
-            f.data_ = nullptr;
+            steal(f);
         }
 
         movable_function& operator=(movable_function const&) = delete;
         movable_function& operator=(movable_function&& f) noexcept {
-            destroy();
-            invoke_f_  = f.invoke_f_;
-            destroy_f_ = f.destroy_f_;
-            data_      = f.data_;
-            f.data_ = nullptr;
+            if (this != &f) {
+                destroy();
+                steal(f);
+            }
+            return *this;
         }
 
         Res operator()(Args&&...args) {
-            return invoke_f_(data_, std::forward<Args>(args)...);
+            return vtable_->invoke(storage_, std::forward<Args>(args)...);
         }
 
         bool is_valid() const noexcept {
-            return data_ != nullptr;
+            return vtable_ != nullptr;
         }
         operator bool() const noexcept {
             return is_valid();
@@ -93,34 +169,89 @@ namespace sc {
         }
 
         void swap(movable_function& f) noexcept {
-            const auto invoke  = invoke_f_;
-            const auto destroy = destroy_f_;
-            const auto data    = data_;
-
-            invoke_f_  = f.invoke_f_;
-            destroy_f_ = f.destroy_f_;
-            data_      = f.data_;
-
-            f.invoke_f_  = invoke;
-            f.destroy_f_ = destroy;
-            f.data_      = data;
+            movable_function tmp = std::move(f);
+            f = std::move(*this);
+            *this = std::move(tmp);
         }
     private:
-        invoke_f_t invoke_f_;
-        destroy_f_t destroy_f_;
-        char* data_;
+        vtable_t const* vtable_;
+        storage_t storage_;
+
+        void steal(movable_function& f) noexcept {
+            if (!f.is_valid()) return;
+            if (f.vtable_->move == nullptr) {
+                std::memcpy(&storage_, &f.storage_, sizeof(storage_t));
+            }
+            else {
+                f.vtable_->move(storage_, f.storage_);
+            }
+            vtable_ = f.vtable_;
+            f.vtable_ = nullptr;
+        }
 
         void destroy() noexcept {
-            if (data_) {
-                destroy_f_(data_);
-                data_ = nullptr;
+            if (is_valid()) {
+                vtable_->destroy(storage_);
+                vtable_ = nullptr;
             }
         }
     };
 
-    template <class Res, class...Args>
-    void swap(movable_function<Res, Args...>& f1, movable_function<Res, Args...>& f2) {
+    template <class Signature, size_t INLINE_SIZE>
+    void swap(movable_function<Signature, INLINE_SIZE>& f1, movable_function<Signature, INLINE_SIZE>& f2) {
         f1.swap(f2);
     };
 
+
+    /// Non-owning reference to a callable, two pointers large and never allocating.
+    /// The callable must outlive the function_ref (useful for callbacks parameters).
+
+    template <class> class function_ref;
+
+    template <class Res, class...Args>
+    class function_ref<Res(Args...)> {
+        using fun_t = Res (*) (Args...);
+
+        union data_t {
+            void* object;
+            fun_t fun;
+        };
+        using invoke_f_t = Res (*) (data_t data, Args&&...args);
+
+        template <class F>
+        static Res invoke_f(data_t data, Args&&...args) {
+            return (*static_cast<F*>(data.object))(std::forward<Args>(args)...);
+        }
+        static Res invoke_fun_f(data_t data, Args&&...args) {
+            return data.fun(std::forward<Args>(args)...);
+        }
+
+    public:
+        template <class F, class = std::enable_if_t<
+                !std::is_same_v<std::decay_t<F>, function_ref> &&
+                std::is_invocable_r_v<Res, F&, Args...>
+        >>
+        function_ref(F&& f) noexcept {
+            if constexpr (std::is_convertible_v<F, fun_t> && (std::is_function_v<std::remove_reference_t<F>> ||
+                                                              std::is_pointer_v<std::decay_t<F>>)) {
+                data_.fun = f;
+                invoke_f_ = invoke_fun_f;
+            }
+            else {
+                data_.object = const_cast<void*>(static_cast<void const*>(std::addressof(f)));
+                invoke_f_ = invoke_f<std::remove_reference_t<F>>;
+            }
+        }
+
+        function_ref(function_ref const&) noexcept = default;
+        function_ref& operator=(function_ref const&) noexcept = default;
+
+        Res operator()(Args...args) const {
+            return invoke_f_(data_, std::forward<Args>(args)...);
+        }
+    private:
+        data_t data_;
+        invoke_f_t invoke_f_;
+    };
+
 }
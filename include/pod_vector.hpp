@@ -2,24 +2,94 @@
 #pragma once
 
 #include <cstring>
+#include <cstdlib>
+#include <new>
+#include <memory>
+#include <algorithm>
+#include <iterator>
+#include <limits>
+#include <cstdint>
 #include "pointer_iterators.hpp"
+#include "type_traits.hpp"
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#endif
 
 
 namespace sc {
 
-    template <class T, class Allocator = std::allocator<T>>
-    class pod_vector {
+    // Growth policies, giving the new capacity of a full pod_vector.
+    // Computed in 64 bits, then clamped to the maximal int capacity.
+
+    namespace detail {
+        inline int clamp_capacity(int64_t capacity) {
+            return static_cast<int>(std::min<int64_t>(capacity, std::numeric_limits<int>::max()));
+        }
+    }
+
+    namespace growth_policy {
+        struct one_and_half {
+            static int next_capacity(int capacity, int required, size_t) {
+                return detail::clamp_capacity(std::max<int64_t>(int64_t(capacity) + capacity / 2, required));
+            }
+        };
+        struct doubling {
+            static int next_capacity(int capacity, int required, size_t) {
+                return detail::clamp_capacity(std::max<int64_t>(2 * int64_t(capacity), required));
+            }
+        };
+        // Doubles, then fills the last memory page
+        struct page_rounded {
+            static constexpr size_t page_bytes = 4096;
+
+            static int next_capacity(int capacity, int required, size_t valueSize) {
+                const auto bytes = static_cast<size_t>(std::max<int64_t>(2 * int64_t(capacity), required)) * valueSize;
+                return detail::clamp_capacity(static_cast<int64_t>((bytes + page_bytes - 1) / page_bytes * page_bytes / valueSize));
+            }
+        };
+    }
+
+    /// Allocator which can grow an allocation in place : realloc for small ones, and on Linux mremap for the
+    /// ones above mmap_threshold_bytes (mapped with an huge pages hint). pod_vector uses its reallocate method.
+
+    template <class T>
+    class realloc_allocator {
+        static_assert(alignof(T) <= alignof(std::max_align_t), "Over-aligned types are not supported");
     public:
-        static float growing_factor();
+        using value_type = T;
+        static constexpr size_t mmap_threshold_bytes = size_t(2) << 20;
+
+        realloc_allocator() noexcept = default;
+        template <class U>
+        realloc_allocator(realloc_allocator<U> const&) noexcept {}
+
+        T* allocate(size_t nb);
+        void deallocate(T* ptr, size_t nb) noexcept;
+        T* reallocate(T* ptr, size_t oldNb, size_t newNb);
 
+        template <class U>
+        bool operator==(realloc_allocator<U> const&) const noexcept { return true; }
+        template <class U>
+        bool operator!=(realloc_allocator<U> const&) const noexcept { return false; }
+    private:
+        static bool is_mapped(size_t nb);
+        static size_t mapped_bytes(size_t nb);
+    };
+
+    template <class T, class Allocator = std::allocator<T>, class Growth = growth_policy::doubling>
+    class pod_vector {
+        static_assert(is_trivially_relocatable<T>, "pod_vector moves its values with memcpy");
+        static_assert(std::is_trivially_destructible_v<T>, "pod_vector never destroys its values");
+    public:
         using value_type = T;
         using allocator_type = Allocator;
         using size_type = int;
 
-        using iterator = pointer_iterator<pod_vector<T>, T>;
-        using const_iterator = const_pointer_iterator<pod_vector<T>, T>;
-        using reverse_iterator = reverse_pointer_iterator<pod_vector<T>, T>;
-        using const_reverse_iterator = const_reverse_pointer_iterator<pod_vector<T>, T>;
+        using iterator = pointer_iterator<pod_vector, T>;
+        using const_iterator = const_pointer_iterator<pod_vector, T>;
+        using reverse_iterator = reverse_pointer_iterator<pod_vector, T>;
+        using const_reverse_iterator = const_reverse_pointer_iterator<pod_vector, T>;
 
         explicit pod_vector(Allocator const& allocator = Allocator()) noexcept;
         ~pod_vector() noexcept;
@@ -32,6 +102,8 @@ namespace sc {
 
         void reserve(int capacity);
         void resize(int size);
+        // Like resize, but grows the capacity with the growth policy (for buffers filled afterward)
+        void resize_uninitialized(int size);
         void shrink_to_fit();
         void clear()         { size_ = 0; }
         int size() const     { return size_; }
@@ -51,6 +123,14 @@ namespace sc {
         T& emplace_back(Args&&...args);
         void pop_back();
 
+        // Bulk operations on forward iterators, the inserted values must not come from the vector itself
+        void append(T const* values, int nb);
+        template <class ForwardIt>
+        iterator insert(iterator pos, ForwardIt first, ForwardIt last);
+        iterator erase(iterator first, iterator last);
+        template <class ForwardIt>
+        void assign(ForwardIt first, ForwardIt last);
+
         iterator begin()                       { return iterator(data_); }
         iterator end()                         { return iterator(data_ + size_); }
         const_iterator cbegin() const          { return const_iterator(data_); }
@@ -61,6 +141,7 @@ namespace sc {
         const_reverse_iterator crend() const   { return const_reverse_iterator(data_ - 1); }
     private:
         void reallocate(int capacity);
+        void grow(int size);
 
         int size_;
         int capacity_;
@@ -68,37 +149,150 @@ namespace sc {
         Allocator allocator_;
     };
 
-    template<class T, class Allocator>
-    float pod_vector<T, Allocator>::growing_factor() {
-        return 2.f;
+    // ______________
+    // Implementation
+
+    template <class T>
+    T* realloc_allocator<T>::allocate(size_t nb) {
+        if (nb == 0) return nullptr;
+#if defined(__linux__)
+        if (is_mapped(nb)) {
+            void* ptr = mmap(nullptr, mapped_bytes(nb), PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+            if (ptr == MAP_FAILED) throw std::bad_alloc{};
+            madvise(ptr, mapped_bytes(nb), MADV_HUGEPAGE);
+            return static_cast<T*>(ptr);
+        }
+#endif
+        void* ptr = std::malloc(nb * sizeof(T));
+        if (ptr == nullptr) throw std::bad_alloc{};
+        return static_cast<T*>(ptr);
+    }
+
+    template <class T>
+    void realloc_allocator<T>::deallocate(T* ptr, size_t nb) noexcept {
+        if (ptr == nullptr) return;
+#if defined(__linux__)
+        if (is_mapped(nb)) {
+            munmap(ptr, mapped_bytes(nb));
+            return;
+        }
+#endif
+        std::free(ptr);
+    }
+
+    template <class T>
+    T* realloc_allocator<T>::reallocate(T* ptr, size_t oldNb, size_t newNb) {
+        if (ptr == nullptr) return allocate(newNb);
+        if (newNb == 0) {
+            deallocate(ptr, oldNb);
+            return nullptr;
+        }
+#if defined(__linux__)
+        if (is_mapped(oldNb) && is_mapped(newNb)) {
+            // Moves the pages mapping, values are never copied
+            void* newPtr = mremap(ptr, mapped_bytes(oldNb), mapped_bytes(newNb), MREMAP_MAYMOVE);
+            if (newPtr == MAP_FAILED) throw std::bad_alloc{};
+            return static_cast<T*>(newPtr);
+        }
+        if (is_mapped(oldNb) || is_mapped(newNb)) {
+            T* const newPtr = allocate(newNb);
+            std::memcpy(static_cast<void*>(newPtr), static_cast<void const*>(ptr), std::min(oldNb, newNb) * sizeof(T));
+            deallocate(ptr, oldNb);
+            return newPtr;
+        }
+#endif
+        void* newPtr = std::realloc(ptr, newNb * sizeof(T));
+        if (newPtr == nullptr) throw std::bad_alloc{};
+        return static_cast<T*>(newPtr);
+    }
+
+    template <class T>
+    bool realloc_allocator<T>::is_mapped(size_t nb) {
+        return nb * sizeof(T) >= mmap_threshold_bytes;
+    }
+
+    template <class T>
+    size_t realloc_allocator<T>::mapped_bytes(size_t nb) {
+        return (nb * sizeof(T) + growth_policy::page_rounded::page_bytes - 1) /
+            growth_policy::page_rounded::page_bytes * growth_policy::page_rounded::page_bytes;
     }
 
-    template<class T, class Allocator>
-    pod_vector<T, Allocator>::pod_vector(Allocator const& allocator) noexcept :
+    namespace detail {
+        template <class Allocator, class SFINAE = void>
+        constexpr bool has_reallocate = false;
+
+        template <class Allocator>
+        constexpr bool has_reallocate<Allocator, std::void_t<
+            decltype(std::declval<Allocator&>().reallocate(nullptr, size_t(), size_t()))
+        >> = true;
+
+        // Moves nb values with a memmove (the ranges can overlap), no constructor nor destructor is called
+        template <class T>
+        void relocate_values(T* dst, T const* src, int nb) noexcept {
+            if (nb > 0) {
+                std::memmove(static_cast<void*>(dst), static_cast<void const*>(src), static_cast<size_t>(nb) * sizeof(T));
+            }
+        }
+
+        // Copies nb values into uninitialized memory, with a memcpy when T is trivially copyable
+        template <class T, class ForwardIt>
+        void copy_values(T* dst, ForwardIt first, int nb) {
+            if constexpr (std::is_trivially_copyable_v<T> && std::is_pointer_v<ForwardIt> &&
+                          std::is_same_v<std::remove_cv_t<std::remove_pointer_t<ForwardIt>>, T>) {
+                if (nb > 0) {
+                    std::memcpy(static_cast<void*>(dst), static_cast<void const*>(first), static_cast<size_t>(nb) * sizeof(T));
+                }
+            }
+            else {
+                std::uninitialized_copy_n(first, nb, dst);
+            }
+        }
+
+        // Array operations shared by pod_vector and small_pod_vector, the capacity must already be large enough.
+        // They return the position of the first inserted or erased value.
+
+        template <class T, class ForwardIt>
+        T* insert_values(T* data, int size, int index, ForwardIt first, int nb) {
+            T* const dst = data + index;
+            relocate_values(dst + nb, dst, size - index);
+            copy_values(dst, first, nb);
+            return dst;
+        }
+
+        template <class T>
+        T* erase_values(T* data, int size, int index, int nb) noexcept {
+            T* const dst = data + index;
+            relocate_values(dst, dst + nb, size - index - nb);
+            return dst;
+        }
+    }
+
+    template<class T, class Allocator, class Growth>
+    pod_vector<T, Allocator, Growth>::pod_vector(Allocator const& allocator) noexcept :
             size_{0},
             capacity_{0},
             data_{nullptr},
             allocator_{allocator}
     {}
 
-    template<class T, class Allocator>
-    pod_vector<T, Allocator>::~pod_vector() noexcept {
+    template<class T, class Allocator, class Growth>
+    pod_vector<T, Allocator, Growth>::~pod_vector() noexcept {
         std::allocator_traits<Allocator>::deallocate(allocator_, data_, capacity_);
     }
 
-    template<class T, class Allocator>
-    pod_vector<T, Allocator>::pod_vector(pod_vector const &clone) :
+    template<class T, class Allocator, class Growth>
+    pod_vector<T, Allocator, Growth>::pod_vector(pod_vector const &clone) :
             size_{clone.size_},
             capacity_{clone.size_},
             data_{nullptr},
             allocator_{clone.allocator_}
     {
         data_ = std::allocator_traits<Allocator>::allocate(allocator_, capacity_);
-        std::memcpy(data_, clone.data_, static_cast<size_t>(size_));
+        detail::copy_values(data_, clone.data_, size_);
     }
 
-    template<class T, class Allocator>
-    pod_vector<T, Allocator>::pod_vector(pod_vector &&clone) noexcept :
+    template<class T, class Allocator, class Growth>
+    pod_vector<T, Allocator, Growth>::pod_vector(pod_vector &&clone) noexcept :
             size_{clone.size_},
             capacity_{clone.capacity_},
             data_{clone.data_},
@@ -109,20 +303,20 @@ namespace sc {
         clone.capacity_ = 0;
     }
 
-    template<class T, class Allocator>
-    pod_vector<T, Allocator> &pod_vector<T, Allocator>::operator=(pod_vector const &clone) {
+    template<class T, class Allocator, class Growth>
+    pod_vector<T, Allocator, Growth> &pod_vector<T, Allocator, Growth>::operator=(pod_vector const &clone) {
         size_ = clone.size_;
         if (capacity_ < size_) {
             std::allocator_traits<Allocator>::deallocate(allocator_, data_, capacity_);
             data_ = std::allocator_traits<Allocator>::allocate(allocator_, size_);
             capacity_ = size_;
         }
-        std::memcpy(data_, clone.data_, static_cast<size_t>(size_));
+        detail::copy_values(data_, clone.data_, size_);
         return *this;
     }
 
-    template<class T, class Allocator>
-    pod_vector<T, Allocator> &pod_vector<T, Allocator>::operator=(pod_vector &&clone) noexcept {
+    template<class T, class Allocator, class Growth>
+    pod_vector<T, Allocator, Growth> &pod_vector<T, Allocator, Growth>::operator=(pod_vector &&clone) noexcept {
         std::allocator_traits<Allocator>::deallocate(allocator_, data_, capacity_);
         size_ = clone.size_;
         capacity_ = clone.capacity_;
@@ -136,8 +330,8 @@ namespace sc {
         return *this;
     }
 
-    template<class T, class Allocator>
-    pod_vector<T, Allocator>::pod_vector(int size, const Allocator &allocator) :
+    template<class T, class Allocator, class Growth>
+    pod_vector<T, Allocator, Growth>::pod_vector(int size, const Allocator &allocator) :
             size_{size},
             capacity_{size},
             data_{nullptr},
@@ -146,50 +340,107 @@ namespace sc {
         data_ = std::allocator_traits<Allocator>::allocate(allocator_, capacity_);
     }
 
-    template<class T, class Allocator>
-    void pod_vector<T, Allocator>::reserve(int capacity) {
+    template<class T, class Allocator, class Growth>
+    void pod_vector<T, Allocator, Growth>::reserve(int capacity) {
         if (capacity <= capacity_) return;
         reallocate(capacity);
     }
 
-    template<class T, class Allocator>
-    void pod_vector<T, Allocator>::resize(int size) {
+    template<class T, class Allocator, class Growth>
+    void pod_vector<T, Allocator, Growth>::resize(int size) {
         if (capacity_ < size) {
             reallocate(size);
         }
         size_ = size;
     }
 
-    template<class T, class Allocator>
-    void pod_vector<T, Allocator>::shrink_to_fit() {
+    template<class T, class Allocator, class Growth>
+    void pod_vector<T, Allocator, Growth>::resize_uninitialized(int size) {
+        grow(size);
+        size_ = size;
+    }
+
+    template<class T, class Allocator, class Growth>
+    void pod_vector<T, Allocator, Growth>::shrink_to_fit() {
         if (size_ == capacity_) return;
 
         reallocate(size_);
     }
 
-    template<class T, class Allocator>
+    template<class T, class Allocator, class Growth>
     template<class... Args>
-    T &pod_vector<T, Allocator>::emplace_back(Args &&... args) {
-        if (size_ == capacity_) {
-            reallocate(static_cast<int>(size_ * growing_factor()));
-        }
+    T &pod_vector<T, Allocator, Growth>::emplace_back(Args &&... args) {
+        grow(size_ + 1);
         ++size_;
         new (&back()) T(std::forward<Args>(args)...);
         return back();
     }
 
-    template<class T, class Allocator>
-    void pod_vector<T, Allocator>::pop_back() {
+    template<class T, class Allocator, class Growth>
+    void pod_vector<T, Allocator, Growth>::pop_back() {
         --size_;
     }
 
-    template<class T, class Allocator>
-    void pod_vector<T, Allocator>::reallocate(int capacity) {
-        T* const data = std::allocator_traits<Allocator>::allocate(allocator_, capacity);
-        std::memcpy(data, data_, static_cast<size_t>(size_));
-        std::allocator_traits<Allocator>::deallocate(allocator_, data_, capacity_);
+    template<class T, class Allocator, class Growth>
+    void pod_vector<T, Allocator, Growth>::append(T const* values, int nb) {
+        grow(size_ + nb);
+        detail::copy_values(data_ + size_, values, nb);
+        size_ += nb;
+    }
+
+    template<class T, class Allocator, class Growth>
+    template<class ForwardIt>
+    typename pod_vector<T, Allocator, Growth>::iterator
+    pod_vector<T, Allocator, Growth>::insert(iterator pos, ForwardIt first, ForwardIt last) {
+        static_assert(std::is_base_of_v<std::forward_iterator_tag, typename std::iterator_traits<ForwardIt>::iterator_category>,
+                      "The range is traversed twice, to count then to copy the values");
+        const int index = static_cast<int>(pos - begin());
+        const int nb = static_cast<int>(std::distance(first, last));
+        grow(size_ + nb);
+
+        T* const dst = detail::insert_values(data_, size_, index, first, nb);
+        size_ += nb;
+        return iterator(dst);
+    }
+
+    template<class T, class Allocator, class Growth>
+    typename pod_vector<T, Allocator, Growth>::iterator
+    pod_vector<T, Allocator, Growth>::erase(iterator first, iterator last) {
+        const int index = static_cast<int>(first - begin());
+        const int nb = static_cast<int>(last - first);
+
+        T* const dst = detail::erase_values(data_, size_, index, nb);
+        size_ -= nb;
+        return iterator(dst);
+    }
+
+    template<class T, class Allocator, class Growth>
+    template<class ForwardIt>
+    void pod_vector<T, Allocator, Growth>::assign(ForwardIt first, ForwardIt last) {
+        size_ = 0;
+        insert(begin(), first, last);
+    }
+
+    template<class T, class Allocator, class Growth>
+    void pod_vector<T, Allocator, Growth>::grow(int size) {
+        if (size > capacity_) {
+            reallocate(Growth::next_capacity(capacity_, size, sizeof(T)));
+        }
+    }
+
+    template<class T, class Allocator, class Growth>
+    void pod_vector<T, Allocator, Growth>::reallocate(int capacity) {
+        // Values are relocated, so no move constructor nor destructor is called
+        if constexpr (detail::has_reallocate<Allocator>) {
+            data_ = allocator_.reallocate(data_, static_cast<size_t>(capacity_), static_cast<size_t>(capacity));
+        }
+        else {
+            T* const data = std::allocator_traits<Allocator>::allocate(allocator_, capacity);
+            detail::relocate_values(data, data_, size_);
+            std::allocator_traits<Allocator>::deallocate(allocator_, data_, capacity_);
+            data_ = data;
+        }
         capacity_ = capacity;
-        data_ = data;
     }
 
 
@@ -0,0 +1,101 @@
+#pragma once
+
+#include <cstring>
+#include <cstdint>
+#include <type_traits>
+#include <serializer_span.hpp>
+#include <slot_map.hpp>
+
+
+// sc::slot_map operations
+// The dense array, indices and free keys are copied in bulk, so every key stays valid after a restore.
+// Values of trivially copyable types are copied with the keys in a single memcpy.
+
+namespace sc::detail::span {
+    // Empty arrays can have a null data pointer, which can't be given to memcpy
+    inline void read_bytes(input& span, void* data, size_t size) {
+        if (size == 0) return;
+        std::memcpy(data, span.begin, size);
+        span.begin += size;
+    }
+    inline void write_bytes(output& span, void const* data, size_t size) {
+        if (size == 0) return;
+        std::memcpy(span.begin, data, size);
+        span.begin += size;
+    }
+
+    template <class T, class Allocator>
+    struct operation<input, slot_map<T, Allocator>> {
+        using map_t = slot_map<T, Allocator>;
+
+        static input& invoke(input& span, map_t& map) {
+            int32_t objectsCount, indicesCount, freeKeysCount;
+            span & objectsCount & indicesCount & freeKeysCount;
+
+            map.clear();
+            if constexpr (std::is_trivially_copyable_v<T>) {
+                map.objects_.resize(static_cast<size_t>(objectsCount));
+                read_bytes(span, map.objects_.data(), objectsCount * sizeof(typename map_t::data_t));
+            }
+            else {
+                map.objects_.reserve(static_cast<size_t>(objectsCount));
+                for (int i = 0; i < objectsCount; ++i) {
+                    auto& data = map.objects_.emplace_back(typename map_t::key{});
+                    span & data.val;
+                    read_bytes(span, &data.k, sizeof(data.k));
+                }
+            }
+            map.indices_.resize(static_cast<size_t>(indicesCount));
+            read_bytes(span, map.indices_.data(), indicesCount * sizeof(typename map_t::key));
+            map.freeKeys_.resize(static_cast<size_t>(freeKeysCount));
+            read_bytes(span, map.freeKeys_.data(), freeKeysCount * sizeof(typename map_t::key));
+            map.size_ = objectsCount;
+            return span;
+        }
+    };
+
+    template <class T, class Allocator>
+    struct operation<output, slot_map<T, Allocator>> {
+        using map_t = slot_map<T, Allocator>;
+
+        static output& invoke(output& span, map_t& map) {
+            auto objectsCount  = static_cast<int32_t>(map.objects_.size());
+            auto indicesCount  = static_cast<int32_t>(map.indices_.size());
+            auto freeKeysCount = static_cast<int32_t>(map.freeKeys_.size());
+            span & objectsCount & indicesCount & freeKeysCount;
+
+            if constexpr (std::is_trivially_copyable_v<T>) {
+                write_bytes(span, map.objects_.data(), objectsCount * sizeof(typename map_t::data_t));
+            }
+            else {
+                for (auto& data : map.objects_) {
+                    span & data.val;
+                    write_bytes(span, &data.k, sizeof(data.k));
+                }
+            }
+            write_bytes(span, map.indices_.data(), indicesCount * sizeof(typename map_t::key));
+            write_bytes(span, map.freeKeys_.data(), freeKeysCount * sizeof(typename map_t::key));
+            return span;
+        }
+    };
+
+    template <class T, class Allocator>
+    struct operation<accumulator, slot_map<T, Allocator>> {
+        using map_t = slot_map<T, Allocator>;
+
+        static accumulator& invoke(accumulator& acc, map_t& map) {
+            acc.value += 3 * serialized_size<int32_t>();
+            if constexpr (std::is_trivially_copyable_v<T>) {
+                acc.value += static_cast<int>(map.objects_.size() * sizeof(typename map_t::data_t));
+            }
+            else {
+                for (auto& data : map.objects_) {
+                    acc & data.val;
+                    acc.value += static_cast<int>(sizeof(data.k));
+                }
+            }
+            acc.value += static_cast<int>((map.indices_.size() + map.freeKeys_.size()) * sizeof(typename map_t::key));
+            return acc;
+        }
+    };
+}
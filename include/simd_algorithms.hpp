@@ -0,0 +1,295 @@
+#pragma once
+
+#include <cstring>
+#include <cstdint>
+#include <algorithm>
+#include <numeric>
+#include <type_traits>
+#include "pod_vector.hpp"
+
+#if (defined(__clang__) || defined(__GNUG__)) && (defined(__x86_64__) || defined(__i386__))
+#define SC_SIMD_X86
+#endif
+
+
+namespace sc::simd {
+
+    /// Bulk operations on arrays of arithmetic values. On x86 with gcc or clang, they are vectorized with SSE,
+    /// or AVX2 when the cpu supports it (checked once at runtime). Other targets use scalar loops.
+
+    template <class T>
+    void fill(T* data, int size, T val);
+    // Index of the first value equal to val, or -1
+    template <class T>
+    int find(T const* data, int size, T val);
+    template <class T>
+    int count(T const* data, int size, T val);
+    // size must be superior to zero
+    template <class T>
+    T min(T const* data, int size);
+    template <class T>
+    T max(T const* data, int size);
+    // Accumulated in T (float sums can differ slightly from a sequential sum)
+    template <class T>
+    T sum(T const* data, int size);
+    template <class T>
+    bool equal(T const* data1, T const* data2, int size);
+
+    // pod_vector overloads
+
+    template <class T, class A, class G>
+    void fill(pod_vector<T, A, G>& vec, T val)                  { fill(vec.data(), vec.size(), val); }
+    template <class T, class A, class G>
+    int find(pod_vector<T, A, G> const& vec, T val)             { return find(vec.data(), vec.size(), val); }
+    template <class T, class A, class G>
+    int count(pod_vector<T, A, G> const& vec, T val)            { return count(vec.data(), vec.size(), val); }
+    template <class T, class A, class G>
+    T min(pod_vector<T, A, G> const& vec)                       { return min(vec.data(), vec.size()); }
+    template <class T, class A, class G>
+    T max(pod_vector<T, A, G> const& vec)                       { return max(vec.data(), vec.size()); }
+    template <class T, class A, class G>
+    T sum(pod_vector<T, A, G> const& vec)                       { return sum(vec.data(), vec.size()); }
+    template <class T, class A, class G1, class G2>
+    bool equal(pod_vector<T, A, G1> const& vec1, pod_vector<T, A, G2> const& vec2) {
+        return vec1.size() == vec2.size() && equal(vec1.data(), vec2.data(), vec1.size());
+    }
+
+    // ______________
+    // Implementation
+
+    namespace detail {
+        template <class T>
+        constexpr bool is_simd_value = std::is_arithmetic_v<T> && !std::is_same_v<T, bool>;
+
+#if defined(SC_SIMD_X86)
+        inline bool has_avx2() {
+            static const bool avx2 = __builtin_cpu_supports("avx2");
+            return avx2;
+        }
+
+        // Kernels written with vector extensions, BYTES wide.
+        // Vectors are only passed by reference, so 32 bytes ones never go through a non-AVX calling convention.
+
+        template <int BYTES, class T>
+        struct vector {
+            typedef T type __attribute__((vector_size(BYTES)));
+            static constexpr int lanes = BYTES / sizeof(T);
+
+            __attribute__((always_inline)) static void load(type& v, T const* data) {
+                std::memcpy(&v, data, sizeof(type));
+            }
+            __attribute__((always_inline)) static void store(T* data, type const& v) {
+                std::memcpy(data, &v, sizeof(type));
+            }
+        };
+
+        template <class Mask>
+        __attribute__((always_inline)) inline bool any_lane(Mask const& mask) {
+            uint64_t words[sizeof(Mask) / sizeof(uint64_t)];
+            std::memcpy(words, &mask, sizeof(Mask));
+            uint64_t any = 0;
+            for (uint64_t word : words) any |= word;
+            return any != 0;
+        }
+
+        struct fill_op {
+            template <int BYTES, class T>
+            __attribute__((always_inline)) static void run(T* data, int size, T val) {
+                using vec = vector<BYTES, T>;
+                const typename vec::type v = typename vec::type{} + val;
+                int i = 0;
+                for (; i + vec::lanes <= size; i += vec::lanes) vec::store(data + i, v);
+                for (; i < size; ++i) data[i] = val;
+            }
+        };
+
+        struct find_op {
+            template <int BYTES, class T>
+            __attribute__((always_inline)) static int run(T const* data, int size, T val) {
+                using vec = vector<BYTES, T>;
+                const typename vec::type v = typename vec::type{} + val;
+                typename vec::type values;
+                int i = 0;
+                for (; i + vec::lanes <= size; i += vec::lanes) {
+                    vec::load(values, data + i);
+                    if (any_lane(values == v)) break;
+                }
+                for (; i < size; ++i) {
+                    if (data[i] == val) return i;
+                }
+                return -1;
+            }
+        };
+
+        struct count_op {
+            template <int BYTES, class T>
+            __attribute__((always_inline)) static int run(T const* data, int size, T val) {
+                using vec = vector<BYTES, T>;
+                using mask_t = decltype(std::declval<typename vec::type>() == std::declval<typename vec::type>());
+                const typename vec::type v = typename vec::type{} + val;
+                typename vec::type values;
+                int count = 0;
+                int i = 0;
+                while (i + vec::lanes <= size) {
+                    // Lanes counters are flushed before overflowing, even for 8 bits values
+                    mask_t counters{};
+                    for (int j = 0; j < 127 && i + vec::lanes <= size; ++j, i += vec::lanes) {
+                        vec::load(values, data + i);
+                        counters -= values == v;
+                    }
+                    for (int lane = 0; lane < vec::lanes; ++lane) count += static_cast<int>(counters[lane]);
+                }
+                for (; i < size; ++i) count += data[i] == val;
+                return count;
+            }
+        };
+
+        template <bool MIN>
+        struct min_max_op {
+            template <int BYTES, class T>
+            __attribute__((always_inline)) static T run(T const* data, int size) {
+                using vec = vector<BYTES, T>;
+                T result = data[0];
+                int i = 0;
+                if (size >= vec::lanes) {
+                    typename vec::type acc, v;
+                    vec::load(acc, data);
+                    for (i = vec::lanes; i + vec::lanes <= size; i += vec::lanes) {
+                        vec::load(v, data + i);
+                        if constexpr (MIN) acc = v < acc ? v : acc;
+                        else acc = v > acc ? v : acc;
+                    }
+                    for (int lane = 0; lane < vec::lanes; ++lane) {
+                        result = MIN ? std::min(result, acc[lane]) : std::max(result, acc[lane]);
+                    }
+                }
+                for (; i < size; ++i) {
+                    result = MIN ? std::min(result, data[i]) : std::max(result, data[i]);
+                }
+                return result;
+            }
+        };
+
+        struct sum_op {
+            template <int BYTES, class T>
+            __attribute__((always_inline)) static T run(T const* data, int size) {
+                using vec = vector<BYTES, T>;
+                typename vec::type acc{}, values;
+                int i = 0;
+                for (; i + vec::lanes <= size; i += vec::lanes) {
+                    vec::load(values, data + i);
+                    acc += values;
+                }
+                T result = 0;
+                for (int lane = 0; lane < vec::lanes; ++lane) result += acc[lane];
+                for (; i < size; ++i) result += data[i];
+                return result;
+            }
+        };
+
+        struct equal_op {
+            template <int BYTES, class T>
+            __attribute__((always_inline)) static bool run(T const* data1, T const* data2, int size) {
+                using vec = vector<BYTES, T>;
+                typename vec::type values1, values2;
+                int i = 0;
+                for (; i + vec::lanes <= size; i += vec::lanes) {
+                    vec::load(values1, data1 + i);
+                    vec::load(values2, data2 + i);
+                    if (any_lane(values1 != values2)) return false;
+                }
+                for (; i < size; ++i) {
+                    if (data1[i] != data2[i]) return false;
+                }
+                return true;
+            }
+        };
+
+        template <class Op, class...Args>
+        __attribute__((target("avx2"))) auto run_avx2(Args...args) {
+            return Op::template run<32>(args...);
+        }
+        template <class Op, class...Args>
+        auto run_sse(Args...args) {
+            return Op::template run<16>(args...);
+        }
+        template <class Op, class...Args>
+        auto dispatch(Args...args) {
+            if (has_avx2()) return run_avx2<Op>(args...);
+            return run_sse<Op>(args...);
+        }
+#endif
+    }
+
+    template <class T>
+    void fill(T* data, int size, T val) {
+        static_assert(detail::is_simd_value<T>, "Only arithmetic values are supported");
+#if defined(SC_SIMD_X86)
+        detail::dispatch<detail::fill_op>(data, size, val);
+#else
+        std::fill(data, data + size, val);
+#endif
+    }
+
+    template <class T>
+    int find(T const* data, int size, T val) {
+        static_assert(detail::is_simd_value<T>, "Only arithmetic values are supported");
+#if defined(SC_SIMD_X86)
+        return detail::dispatch<detail::find_op>(data, size, val);
+#else
+        T const* const it = std::find(data, data + size, val);
+        return it == data + size ? -1 : static_cast<int>(it - data);
+#endif
+    }
+
+    template <class T>
+    int count(T const* data, int size, T val) {
+        static_assert(detail::is_simd_value<T>, "Only arithmetic values are supported");
+#if defined(SC_SIMD_X86)
+        return detail::dispatch<detail::count_op>(data, size, val);
+#else
+        return static_cast<int>(std::count(data, data + size, val));
+#endif
+    }
+
+    template <class T>
+    T min(T const* data, int size) {
+        static_assert(detail::is_simd_value<T>, "Only arithmetic values are supported");
+#if defined(SC_SIMD_X86)
+        return detail::dispatch<detail::min_max_op<true>>(data, size);
+#else
+        return *std::min_element(data, data + size);
+#endif
+    }
+
+    template <class T>
+    T max(T const* data, int size) {
+        static_assert(detail::is_simd_value<T>, "Only arithmetic values are supported");
+#if defined(SC_SIMD_X86)
+        return detail::dispatch<detail::min_max_op<false>>(data, size);
+#else
+        return *std::max_element(data, data + size);
+#endif
+    }
+
+    template <class T>
+    T sum(T const* data, int size) {
+        static_assert(detail::is_simd_value<T>, "Only arithmetic values are supported");
+#if defined(SC_SIMD_X86)
+        return detail::dispatch<detail::sum_op>(data, size);
+#else
+        return std::accumulate(data, data + size, T(0));
+#endif
+    }
+
+    template <class T>
+    bool equal(T const* data1, T const* data2, int size) {
+        static_assert(detail::is_simd_value<T>, "Only arithmetic values are supported");
+#if defined(SC_SIMD_X86)
+        return detail::dispatch<detail::equal_op>(data1, data2, size);
+#else
+        return std::equal(data1, data1 + size, data2);
+#endif
+    }
+
+}
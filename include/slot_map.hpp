@@ -5,15 +5,23 @@
 
 #include <vector>
 #include <tuple>
+#include <algorithm>
 #include <functional>
 #include <cassert>
 
 
 namespace sc {
 
+    namespace detail::span {
+        template<class Span, class T, class SFINAE>
+        struct operation;
+    }
+
     template<class T, class Allocator = std::allocator<T>>
     class slot_map {
         class data_t;
+        template<class Span, class U, class SFINAE>
+        friend struct detail::span::operation;
     public:
         struct key {
             friend class slot_map<T, Allocator>;
@@ -64,7 +72,17 @@ namespace sc {
         void erase(key k) noexcept;
 
         key get_key(T &val) const noexcept;
+
+        // Sort the objects in place, keys stay valid.
+        template <class Comparator = std::less<T>>
+        void sort(Comparator&& comparator = Comparator());
+
+        // Move the object at position permutation[i] to the position i, keys stay valid.
+        template <class Permutation>
+        void reorder(Permutation const& permutation);
     private:
+        void update_indices() noexcept;
+
         using allocator_key_t  = typename std::allocator_traits<Allocator>::template rebind_alloc<key>;
         using allocator_data_t = typename std::allocator_traits<Allocator>::template rebind_alloc<data_t>;
 
@@ -79,6 +97,9 @@ namespace sc {
             T val;
             key k;
 
+            // Leaves the data uninitialized, used to restore trivial types in bulk
+            data_t() noexcept {}
+
             template <class...Args>
             explicit data_t(key k, Args &&...args) :
                     val(std::forward<Args>(args)...),
@@ -245,4 +266,50 @@ namespace sc {
         return reinterpret_cast<data_t*>(&val)->k;
     }
 
+    template <class T, class Allocator> template <class Comparator>
+    void slot_map<T, Allocator>::sort(Comparator&& comparator) {
+        std::sort(objects_.begin(), objects_.end(), [&comparator] (data_t const& lhs, data_t const& rhs) {
+            return comparator(lhs.val, rhs.val);
+        });
+        update_indices();
+    }
+
+    template <class T, class Allocator> template <class Permutation>
+    void slot_map<T, Allocator>::reorder(Permutation const& permutation) {
+        assert(static_cast<int>(permutation.size()) == size_ && "The permutation must have one index per object");
+#if !defined(NDEBUG)
+        // A repeated index would make the cycles walk loop forever
+        std::vector<bool> used(static_cast<size_t>(size_));
+        for (int i = 0; i < size_; ++i) {
+            const int index = permutation[i];
+            assert(index >= 0 && index < size_ && !used[index] && "The indices must be a permutation of the positions");
+            used[index] = true;
+        }
+#endif
+        std::vector<bool> placed(static_cast<size_t>(size_));
+
+        // Follow each cycle of the permutation, with one temporary object per cycle
+        for (int i = 0; i < size_; ++i) {
+            if (placed[i]) continue;
+            data_t tmp = std::move(objects_[i]);
+            int j = i;
+            for (int next = permutation[j]; next != i; next = permutation[j]) {
+                objects_[j] = std::move(objects_[next]);
+                placed[j] = true;
+                j = next;
+            }
+            objects_[j] = std::move(tmp);
+            placed[j] = true;
+        }
+        update_indices();
+    }
+
+    template <class T, class Allocator>
+    void slot_map<T, Allocator>::update_indices() noexcept {
+        for (int i = 0; i < size_; ++i) {
+            const key k = objects_[i].k;
+            indices_[k.pos()] = {i, k.gen()};
+        }
+    }
+
 }
@@ -0,0 +1,281 @@
+#pragma once
+
+#include <cstring>
+#include <memory>
+#include <algorithm>
+#include <iterator>
+#include "pointer_iterators.hpp"
+#include "type_traits.hpp"
+#include "pod_vector.hpp"
+
+
+namespace sc {
+
+    /// pod_vector storing up to N elements inline, then spilling to memory given by the allocator.
+    /// The capacity is never below N, and moves copy the inline elements.
+
+    template <class T, int N, class Allocator = std::allocator<T>, class Growth = growth_policy::doubling>
+    class small_pod_vector {
+        static_assert(is_trivially_relocatable<T>, "small_pod_vector moves its values with memcpy");
+        static_assert(std::is_trivially_destructible_v<T>, "small_pod_vector never destroys its values");
+        static_assert(N > 0, "Use pod_vector for vectors without inline storage");
+    public:
+        using value_type = T;
+        using allocator_type = Allocator;
+        using size_type = int;
+
+        using iterator = pointer_iterator<small_pod_vector, T>;
+        using const_iterator = const_pointer_iterator<small_pod_vector, T>;
+        using reverse_iterator = reverse_pointer_iterator<small_pod_vector, T>;
+        using const_reverse_iterator = const_reverse_pointer_iterator<small_pod_vector, T>;
+
+        explicit small_pod_vector(Allocator const& allocator = Allocator()) noexcept;
+        ~small_pod_vector() noexcept;
+        small_pod_vector(small_pod_vector const& clone);
+        small_pod_vector(small_pod_vector&& clone) noexcept;
+        small_pod_vector& operator=(small_pod_vector const& clone);
+        small_pod_vector& operator=(small_pod_vector&& clone) noexcept;
+
+        explicit small_pod_vector(int size, Allocator const& allocator = Allocator());
+
+        void reserve(int capacity);
+        void resize(int size);
+        // Like resize, but grows the capacity with the growth policy (for buffers filled afterward)
+        void resize_uninitialized(int size);
+        void shrink_to_fit();
+        void clear()           { size_ = 0; }
+        int size() const       { return size_; }
+        int capacity() const   { return capacity_; }
+        bool empty() const     { return size_ == 0; }
+        bool is_inline() const { return data_ == inline_data(); }
+
+        T* data()                        { return data_; }
+        T const* data() const            { return data_; }
+        T& operator[](int i)             { return data_[i]; }
+        T const& operator[](int i) const { return data_[i]; }
+        T& front()                       { return data_[0]; }
+        T const& front() const           { return data_[0]; }
+        T& back()                        { return data_[size_ - 1]; }
+        T const& back() const            { return data_[size_ - 1]; }
+
+        template <class...Args>
+        T& emplace_back(Args&&...args);
+        void pop_back();
+
+        // Bulk operations on forward iterators, the inserted values must not come from the vector itself
+        void append(T const* values, int nb);
+        template <class ForwardIt>
+        iterator insert(iterator pos, ForwardIt first, ForwardIt last);
+        iterator erase(iterator first, iterator last);
+        template <class ForwardIt>
+        void assign(ForwardIt first, ForwardIt last);
+
+        iterator begin()                       { return iterator(data_); }
+        iterator end()                         { return iterator(data_ + size_); }
+        const_iterator cbegin() const          { return const_iterator(data_); }
+        const_iterator cend() const            { return const_iterator(data_ + size_); }
+        reverse_iterator rbegin()              { return reverse_iterator(data_ + size_ - 1); }
+        reverse_iterator rend()                { return reverse_iterator(data_ - 1); }
+        const_reverse_iterator crbegin() const { return const_reverse_iterator(data_ + size_ - 1); }
+        const_reverse_iterator crend() const   { return const_reverse_iterator(data_ - 1); }
+    private:
+        using storage_t = std::aligned_storage_t<sizeof(T), alignof(T)>;
+
+        T* inline_data()             { return reinterpret_cast<T*>(inline_); }
+        T const* inline_data() const { return reinterpret_cast<T const*>(inline_); }
+
+        void reallocate(int capacity);
+        void grow(int size);
+        void release() noexcept;
+        void steal(small_pod_vector& clone) noexcept;
+
+        int size_;
+        int capacity_;
+        T* data_;
+        Allocator allocator_;
+        storage_t inline_[N];
+    };
+
+    // ______________
+    // Implementation
+
+    template<class T, int N, class Allocator, class Growth>
+    small_pod_vector<T, N, Allocator, Growth>::small_pod_vector(Allocator const& allocator) noexcept :
+            size_{0},
+            capacity_{N},
+            data_{inline_data()},
+            allocator_{allocator}
+    {}
+
+    template<class T, int N, class Allocator, class Growth>
+    small_pod_vector<T, N, Allocator, Growth>::~small_pod_vector() noexcept {
+        release();
+    }
+
+    template<class T, int N, class Allocator, class Growth>
+    small_pod_vector<T, N, Allocator, Growth>::small_pod_vector(small_pod_vector const& clone) :
+            small_pod_vector(clone.allocator_)
+    {
+        append(clone.data_, clone.size_);
+    }
+
+    template<class T, int N, class Allocator, class Growth>
+    small_pod_vector<T, N, Allocator, Growth>::small_pod_vector(small_pod_vector&& clone) noexcept :
+            small_pod_vector(clone.allocator_)
+    {
+        steal(clone);
+    }
+
+    template<class T, int N, class Allocator, class Growth>
+    small_pod_vector<T, N, Allocator, Growth>&
+    small_pod_vector<T, N, Allocator, Growth>::operator=(small_pod_vector const& clone) {
+        if (this != &clone) {
+            size_ = 0;
+            append(clone.data_, clone.size_);
+        }
+        return *this;
+    }
+
+    template<class T, int N, class Allocator, class Growth>
+    small_pod_vector<T, N, Allocator, Growth>&
+    small_pod_vector<T, N, Allocator, Growth>::operator=(small_pod_vector&& clone) noexcept {
+        if (this != &clone) {
+            release();
+            allocator_ = std::move(clone.allocator_);
+            steal(clone);
+        }
+        return *this;
+    }
+
+    template<class T, int N, class Allocator, class Growth>
+    small_pod_vector<T, N, Allocator, Growth>::small_pod_vector(int size, Allocator const& allocator) :
+            small_pod_vector(allocator)
+    {
+        resize(size);
+    }
+
+    template<class T, int N, class Allocator, class Growth>
+    void small_pod_vector<T, N, Allocator, Growth>::reserve(int capacity) {
+        if (capacity <= capacity_) return;
+        reallocate(capacity);
+    }
+
+    template<class T, int N, class Allocator, class Growth>
+    void small_pod_vector<T, N, Allocator, Growth>::resize(int size) {
+        if (capacity_ < size) {
+            reallocate(size);
+        }
+        size_ = size;
+    }
+
+    template<class T, int N, class Allocator, class Growth>
+    void small_pod_vector<T, N, Allocator, Growth>::resize_uninitialized(int size) {
+        grow(size);
+        size_ = size;
+    }
+
+    template<class T, int N, class Allocator, class Growth>
+    void small_pod_vector<T, N, Allocator, Growth>::shrink_to_fit() {
+        if (size_ == capacity_ || is_inline()) return;
+
+        reallocate(size_);
+    }
+
+    template<class T, int N, class Allocator, class Growth>
+    template<class... Args>
+    T& small_pod_vector<T, N, Allocator, Growth>::emplace_back(Args&&... args) {
+        grow(size_ + 1);
+        ++size_;
+        new (&back()) T(std::forward<Args>(args)...);
+        return back();
+    }
+
+    template<class T, int N, class Allocator, class Growth>
+    void small_pod_vector<T, N, Allocator, Growth>::pop_back() {
+        --size_;
+    }
+
+    template<class T, int N, class Allocator, class Growth>
+    void small_pod_vector<T, N, Allocator, Growth>::append(T const* values, int nb) {
+        grow(size_ + nb);
+        detail::copy_values(data_ + size_, values, nb);
+        size_ += nb;
+    }
+
+    template<class T, int N, class Allocator, class Growth>
+    template<class ForwardIt>
+    typename small_pod_vector<T, N, Allocator, Growth>::iterator
+    small_pod_vector<T, N, Allocator, Growth>::insert(iterator pos, ForwardIt first, ForwardIt last) {
+        static_assert(std::is_base_of_v<std::forward_iterator_tag, typename std::iterator_traits<ForwardIt>::iterator_category>,
+                      "The range is traversed twice, to count then to copy the values");
+        const int index = static_cast<int>(pos - begin());
+        const int nb = static_cast<int>(std::distance(first, last));
+        grow(size_ + nb);
+
+        T* const dst = detail::insert_values(data_, size_, index, first, nb);
+        size_ += nb;
+        return iterator(dst);
+    }
+
+    template<class T, int N, class Allocator, class Growth>
+    typename small_pod_vector<T, N, Allocator, Growth>::iterator
+    small_pod_vector<T, N, Allocator, Growth>::erase(iterator first, iterator last) {
+        const int index = static_cast<int>(first - begin());
+        const int nb = static_cast<int>(last - first);
+
+        T* const dst = detail::erase_values(data_, size_, index, nb);
+        size_ -= nb;
+        return iterator(dst);
+    }
+
+    template<class T, int N, class Allocator, class Growth>
+    template<class ForwardIt>
+    void small_pod_vector<T, N, Allocator, Growth>::assign(ForwardIt first, ForwardIt last) {
+        size_ = 0;
+        insert(begin(), first, last);
+    }
+
+    template<class T, int N, class Allocator, class Growth>
+    void small_pod_vector<T, N, Allocator, Growth>::grow(int size) {
+        if (size > capacity_) {
+            reallocate(Growth::next_capacity(capacity_, size, sizeof(T)));
+        }
+    }
+
+    template<class T, int N, class Allocator, class Growth>
+    void small_pod_vector<T, N, Allocator, Growth>::reallocate(int capacity) {
+        // Back to the inline storage when it's large enough
+        T* const data = capacity <= N ? inline_data() : std::allocator_traits<Allocator>::allocate(allocator_, capacity);
+        if (data == data_) return;
+
+        detail::relocate_values(data, data_, size_);
+        release();
+        data_ = data;
+        capacity_ = std::max(capacity, N);
+    }
+
+    template<class T, int N, class Allocator, class Growth>
+    void small_pod_vector<T, N, Allocator, Growth>::release() noexcept {
+        if (!is_inline()) {
+            std::allocator_traits<Allocator>::deallocate(allocator_, data_, capacity_);
+        }
+    }
+
+    template<class T, int N, class Allocator, class Growth>
+    void small_pod_vector<T, N, Allocator, Growth>::steal(small_pod_vector& clone) noexcept {
+        size_ = clone.size_;
+        if (clone.is_inline()) {
+            data_ = inline_data();
+            capacity_ = N;
+            detail::relocate_values(data_, clone.data_, size_);
+        }
+        else {
+            data_ = clone.data_;
+            capacity_ = clone.capacity_;
+            clone.data_ = clone.inline_data();
+            clone.capacity_ = N;
+        }
+        clone.size_ = 0;
+    }
+
+}
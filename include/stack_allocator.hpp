@@ -3,33 +3,65 @@
 
 
 #include <memory>
+#include <memory_resource>
+#include <vector>
+#include <stdexcept>
+#include <cstdint>
+#include <algorithm>
+#include <cassert>
 
 namespace sc {
 
     template <class T>
     class stack_allocator;
 
+    /// When a push does not fit in the current block, the rest of the block is skipped and a new block
+    /// (at least twice bigger than the last one) is chained. The blocks are kept when the stack is rewound,
+    /// so they are reused by the next pushes.
+    /// The size is the position in the chained blocks, it can be saved and restored with rewind().
+    /// A push can consume more than nb bytes (alignment padding, skipped end of block) : rewind() to a saved
+    /// size is the only exact undo, pop(nb) only undoes unaligned pushes made in the current block.
     class stack_resource {
     public:
         explicit stack_resource(int capacity) :
-                data_(std::make_unique<char[]>(static_cast<size_t>(capacity))),
+                current_(0),
                 size_(0),
-                capacity_(capacity)
-        {}
+                capacity_(0)
+        {
+            add_block(capacity);
+        }
         stack_resource(stack_resource&&) = delete;
 
-        void* push(int nb) {
-            if (nb > capacity_ - size_) throw std::runtime_error
-                { "stack_resource could not provide enough memory at push() call." };
-            void* ptr = data_.get() + size_;
-            size_ += nb;
+        void* push(int nb, int alignment = 1) {
+            block_t* block = &blocks_[current_];
+            char* ptr = align(block->data.get() + (size_ - block->begin), alignment);
+            while (ptr + nb > block->data.get() + block->capacity) {
+                if (current_ + 1 == static_cast<int>(blocks_.size())) {
+                    add_block(std::max(2 * blocks_.back().capacity, nb + alignment));
+                }
+                block = &blocks_[++current_];
+                ptr = align(block->data.get(), alignment);
+            }
+            size_ = block->begin + static_cast<int>(ptr + nb - block->data.get());
             return ptr;
         }
 
+        // Removes the last nb bytes, use rewind() to undo aligned or chained pushes
         void pop(int nb) {
             if (nb > size_) throw std::runtime_error
                 { "stack_resource could not free enough memory at pop() call." };
-            size_ -= nb;
+            rewind(size_ - nb);
+        }
+
+        // Restores a size saved before pushes, the blocks chained since stay allocated
+        void rewind(int size) {
+            size_ = size;
+            while (current_ > 0 && size_ <= blocks_[current_].begin) --current_;
+        }
+
+        void clear() {
+            size_ = 0;
+            current_ = 0;
         }
 
         template <class T>
@@ -40,11 +72,30 @@ namespace sc {
         int capacity() const { return capacity_; }
         int size() const     { return size_; }
     private:
-        std::unique_ptr<char[]> data_;
+        struct block_t {
+            std::unique_ptr<char[]> data;
+            int begin;
+            int capacity;
+        };
+
+        void add_block(int capacity) {
+            blocks_.push_back({ std::make_unique<char[]>(static_cast<size_t>(capacity)), capacity_, capacity });
+            capacity_ += capacity;
+        }
+
+        static char* align(char* ptr, int alignment) {
+            const auto address = reinterpret_cast<uintptr_t>(ptr);
+            const auto mask = static_cast<uintptr_t>(alignment - 1);
+            return ptr + (((address + mask) & ~mask) - address);
+        }
+
+        std::vector<block_t> blocks_;
+        int current_;
         int size_;
-        const int capacity_;
+        int capacity_;
     };
 
+    /// Rewinds the stack to its size at construction.
     class stack_guard {
     public:
         explicit stack_guard(stack_resource& stack) :
@@ -54,7 +105,7 @@ namespace sc {
         stack_guard(stack_guard&&) = delete;
 
         ~stack_guard() noexcept {
-            stack_.pop(stack_.size() - index_);
+            stack_.rewind(index_);
         }
 
         template <class T>
@@ -66,8 +117,85 @@ namespace sc {
         int index_;
     };
 
+    /// Two stack resources used alternately, one per frame : the memory allocated during a frame
+    /// stays valid during the next one. next_frame() resets the older resource in O(1) and makes it current.
+    /// The destructors of the allocated objects are not called.
+    class frame_resource {
+    public:
+        explicit frame_resource(int capacity) :
+                frames_{ stack_resource(capacity), stack_resource(capacity) },
+                current_(0)
+        {}
+        frame_resource(frame_resource&&) = delete;
+
+        void* push(int nb, int alignment = 1) {
+            return frames_[current_].push(nb, alignment);
+        }
+
+        void next_frame() {
+            current_ ^= 1;
+            frames_[current_].clear();
+        }
+
+        template <class T>
+        stack_allocator<T> get_allocator() {
+            return frames_[current_].get_allocator<T>();
+        }
+
+        stack_resource& current() { return frames_[current_]; }
+        stack_resource& previous() { return frames_[current_ ^ 1]; }
+    private:
+        stack_resource frames_[2];
+        int current_;
+    };
+
+    // The frame resource of the calling thread, created at the first call with the given capacity (64 KiB if 0).
+    // Later calls must pass the same capacity or 0.
+    inline frame_resource& this_thread_frame_resource(int capacity = 0) {
+        thread_local const int firstCapacity = capacity > 0 ? capacity : 64 * 1024;
+        thread_local frame_resource resource{ firstCapacity };
+        assert(capacity == 0 || capacity == firstCapacity);
+        return resource;
+    }
+
+    /// std::pmr::memory_resource pushing on a stack_resource, for std::pmr containers.
+    /// Requests bigger than maxSize bytes are forwarded to the upstream resource.
+    class stack_memory_resource final : public std::pmr::memory_resource {
+    public:
+        explicit stack_memory_resource(stack_resource& stack,
+                                       std::pmr::memory_resource* upstream = std::pmr::get_default_resource()) :
+                stack_memory_resource(stack, static_cast<size_t>(stack.capacity()), upstream)
+        {}
+        stack_memory_resource(stack_resource& stack, size_t maxSize,
+                              std::pmr::memory_resource* upstream = std::pmr::get_default_resource()) :
+                stack_(stack),
+                maxSize_(maxSize),
+                upstream_(upstream)
+        {}
+
+        stack_resource& stack() const { return stack_; }
+        std::pmr::memory_resource* upstream_resource() const { return upstream_; }
+    private:
+        void* do_allocate(size_t bytes, size_t alignment) override {
+            if (bytes > maxSize_) return upstream_->allocate(bytes, alignment);
+            return stack_.push(static_cast<int>(bytes), static_cast<int>(alignment));
+        }
+        void do_deallocate(void* ptr, size_t bytes, size_t alignment) override {
+            if (bytes > maxSize_) upstream_->deallocate(ptr, bytes, alignment);
+        }
+        bool do_is_equal(std::pmr::memory_resource const& other) const noexcept override {
+            return this == &other;
+        }
+
+        stack_resource& stack_;
+        size_t maxSize_;
+        std::pmr::memory_resource* upstream_;
+    };
+
     template <class T>
     class stack_allocator {
+        template <class U>
+        friend class stack_allocator;
     public:
         using value_type = T;
         using propagate_on_container_move_assignment = std::true_type;
@@ -81,20 +209,24 @@ namespace sc {
         stack_allocator(stack_allocator&& allocator) noexcept = default;
         stack_allocator(stack_allocator const& allocator) = default;
         template <class U>
-        explicit stack_allocator(stack_allocator<U>& allocator) : resource_(allocator.resource_) {}
+        explicit stack_allocator(stack_allocator<U> const& allocator) : resource_(allocator.resource_) {}
 
-        T* allocate(size_t nb) { return static_cast<int*>(resource_.push(sizeof(T) * nb)); }
+        T* allocate(size_t nb) {
+            return static_cast<T*>(resource_.push(static_cast<int>(sizeof(T) * nb), alignof(T)));
+        }
         void deallocate(T *pChunk, size_t nb) {}
+
+        stack_resource& resource() const { return resource_; }
     private:
         stack_resource& resource_;
     };
 
     template <class T, class U>
     bool operator==(stack_allocator<T> const& lhs, stack_allocator<U> const& rhs) {
-        return &lhs.resource_ == &rhs.resource_;
+        return &lhs.resource() == &rhs.resource();
     };
     template <class T, class U>
     bool operator!=(stack_allocator<T> const& lhs, stack_allocator<U> const& rhs) {
-        return &lhs.resource_ != &rhs.resource_;
+        return &lhs.resource() != &rhs.resource();
     };
 }
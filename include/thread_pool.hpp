@@ -7,6 +7,9 @@
 #include <deque>
 #include <atomic>
 #include <future>
+#include <iterator>
+#include <algorithm>
+#include <exception>
 #include "movable_function.hpp"
 
 
@@ -14,6 +17,9 @@ namespace sc {
 
     class thread_pool {
     public:
+        // The tasks store the promise and the given callable inline, without allocation up to 5 pointers captures
+        using task_t = sc::movable_function<void(), sizeof(std::promise<void>) + 5 * sizeof(void*)>;
+
         explicit thread_pool(int threadsCount);
         ~thread_pool();
 
@@ -28,7 +34,19 @@ namespace sc {
             {
                 std::lock_guard lock{tasksMutex_};
                 tasks_.emplace_back([promise = std::move(promise), task = std::forward<F>(f)] () mutable {
-                    promise.set_value(task());
+                    // Exceptions are given to the future instead of stopping the worker
+                    try {
+                        if constexpr (std::is_void_v<return_t>) {
+                            task();
+                            promise.set_value();
+                        }
+                        else {
+                            promise.set_value(task());
+                        }
+                    }
+                    catch (...) {
+                        promise.set_exception(std::current_exception());
+                    }
                 });
             }
             conditionVariable_.notify_one();
@@ -41,10 +59,97 @@ namespace sc {
 
         std::condition_variable conditionVariable_;
 
-        std::deque<sc::movable_function<void()>> tasks_;
+        std::deque<task_t> tasks_;
         std::mutex tasksMutex_;
 
         std::atomic_bool interrupting_;
     };
 
+    /// Parallel algorithms over random-access ranges (std::vector, sc::slot_map, sc::pod_vector...).
+    /// The range is split in chunks of 'grain' elements : the first one is processed by the calling thread,
+    /// the others by the pool. Must not be called from a task of the same pool (it waits for the chunks).
+    /// A grain under 1 is clamped to 1. If f (or reduce) throws, all the chunks are waited before rethrowing
+    /// the first exception.
+
+    // Apply f on each element of the range.
+    template <class Range, class F>
+    void parallel_for_each(thread_pool& pool, Range& range, F&& f, int grain = 1024);
+
+    // Apply f on each element of the range, fold the results of each chunk with 'reduce',
+    // then fold the chunks results in order into 'init'.
+    template <class Range, class T, class F, class Reduce>
+    T parallel_reduce(thread_pool& pool, Range& range, T init, F&& f, Reduce&& reduce, int grain = 1024);
+
+    // ______________
+    // Implementation
+
+    namespace detail {
+        // The chunks reference the caller's stack, so none can be running when it unwinds
+        template <class Future>
+        void wait_all_then_rethrow(std::vector<Future>& futures, std::exception_ptr const& error) {
+            for (auto& future : futures) future.wait();
+            if (error) std::rethrow_exception(error);
+        }
+    }
+
+    template <class Range, class F>
+    void parallel_for_each(thread_pool& pool, Range& range, F&& f, int grain) {
+        const auto begin = std::begin(range);
+        const auto size = static_cast<int>(std::end(range) - begin);
+        if (size == 0) return;
+        grain = std::max(grain, 1);
+
+        auto process_chunk = [&f, begin, size, grain] (int first) {
+            const int last = std::min(first + grain, size);
+            for (int i = first; i < last; ++i) f(begin[i]);
+        };
+
+        std::vector<std::future<void>> futures;
+        futures.reserve(static_cast<size_t>((size - 1) / grain));
+        std::exception_ptr error;
+        try {
+            for (int first = grain; first < size; first += grain) {
+                futures.push_back(pool.execute([&process_chunk, first] { process_chunk(first); }));
+            }
+            process_chunk(0);
+        }
+        catch (...) {
+            error = std::current_exception();
+        }
+        detail::wait_all_then_rethrow(futures, error);
+        for (auto& future : futures) future.get();
+    }
+
+    template <class Range, class T, class F, class Reduce>
+    T parallel_reduce(thread_pool& pool, Range& range, T init, F&& f, Reduce&& reduce, int grain) {
+        const auto begin = std::begin(range);
+        const auto size = static_cast<int>(std::end(range) - begin);
+        if (size == 0) return init;
+        grain = std::max(grain, 1);
+
+        auto process_chunk = [&f, &reduce, begin, size, grain] (int first) {
+            const int last = std::min(first + grain, size);
+            T result = f(begin[first]);
+            for (int i = first + 1; i < last; ++i) result = reduce(std::move(result), f(begin[i]));
+            return result;
+        };
+
+        std::vector<std::future<T>> futures;
+        futures.reserve(static_cast<size_t>((size - 1) / grain));
+        std::exception_ptr error;
+        try {
+            for (int first = grain; first < size; first += grain) {
+                futures.push_back(pool.execute([&process_chunk, first] { return process_chunk(first); }));
+            }
+            init = reduce(std::move(init), process_chunk(0));
+        }
+        catch (...) {
+            error = std::current_exception();
+        }
+        detail::wait_all_then_rethrow(futures, error);
+        // All chunks are done, an exception from get() or reduce is safe to propagate
+        for (auto& future : futures) init = reduce(std::move(init), future.get());
+        return init;
+    }
+
 }
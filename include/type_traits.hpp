@@ -146,4 +146,15 @@ namespace sc {
     template <class T>
     using efficient_argument_t = typename detail::efficient_argument<T>::type;
 
+    // Is trivially relocatable
+    // A moved-from object immediately destroyed can be replaced by a memcpy of its bytes.
+    // Trivially copyable types are, the others can opt in with a specialization (not inherited by derived classes) :
+    // namespace sc { template<> constexpr bool is_trivially_relocatable<MyClass> = true; }
+
+    template <class T>
+    constexpr bool is_trivially_relocatable = std::is_trivially_copyable_v<T>;
+
+    template <class T>
+    constexpr bool is_trivially_relocatable<T const> = is_trivially_relocatable<T>;
+
 };
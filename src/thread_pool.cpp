@@ -15,18 +15,16 @@ namespace sc {
     }
 
     void thread_pool::worker_loop() {
-        sc::movable_function<void()> task;
+        task_t task;
 
-        while (!interrupting_.load()) {
+        while (true) {
             {
+                // The task is popped in the same critical section as the wait, so another worker can't take it
                 std::unique_lock lock{tasksMutex_};
                 conditionVariable_.wait(lock, [this] {
                     return interrupting_.load() || !tasks_.empty();
                 });
-            }
-            if (interrupting_.load()) break;
-            {
-                std::lock_guard lock2{tasksMutex_};
+                if (interrupting_.load()) break;
                 task = std::move(tasks_.front());
                 tasks_.pop_front();
             }
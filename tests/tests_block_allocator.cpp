@@ -2,6 +2,15 @@
 #include "catch.hpp"
 
 #include <block_allocator.hpp>
+#include <map>
+#include <list>
+#include <array>
+#include <unordered_map>
+#include <string>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <atomic>
 
 
 TEST_CASE("block_allocator static", "[block_allocator]") {
@@ -18,4 +27,211 @@ TEST_CASE("block_allocator static", "[block_allocator]") {
     auto i3 = allocator.allocate(1);
 
     REQUIRE(resource.size() == resource.capacity());
+
+    sc::block_allocator_resource<false, int> otherResource(1);
+    REQUIRE(allocator == sc::block_allocator<false, int>(resource));
+    REQUIRE(allocator != sc::block_allocator<false, int>(otherResource));
+    REQUIRE(&allocator.resource() == &resource);
+}
+
+TEST_CASE("block_pool_resource size classes", "[block_allocator]") {
+    sc::block_pool_resource resource(4);
+
+    std::pmr::vector<std::pmr::string> strings(&resource);
+    for (int i = 0; i < 20; ++i) {
+        strings.emplace_back(std::string(static_cast<size_t>(i * 10), 'a'));
+    }
+    std::pmr::map<int, int> map(&resource);
+    for (int i = 0; i < 100; ++i) {
+        map[i] = i;
+    }
+    for (int i = 0; i < 100; i += 2) {
+        map.erase(i);
+    }
+    REQUIRE(map.size() == 50);
+    REQUIRE(strings[19].size() == 190);
+
+    void* small = resource.allocate(24, 8);
+    void* aligned = resource.allocate(8, 64);
+    void* big = resource.allocate(4096, 8);
+    REQUIRE(reinterpret_cast<uintptr_t>(small) % 32 == 0);
+    REQUIRE(reinterpret_cast<uintptr_t>(aligned) % 64 == 0);
+    resource.deallocate(small, 24, 8);
+    resource.deallocate(aligned, 8, 64);
+    resource.deallocate(big, 4096, 8);
+}
+
+TEST_CASE("concurrent_block_allocator_resource cross-thread deallocations", "[block_allocator]") {
+    constexpr int rounds(20);
+    constexpr int blocksCount(1000);
+    using resource_t = sc::concurrent_block_allocator_resource<int>;
+
+    resource_t resource(256, 16);
+    std::vector<int*> blocks;
+    std::mutex mutex;
+    std::atomic_int sum{0};
+    std::atomic_int consumed{0};
+
+    auto producer = std::thread([&] {
+        resource_t::local_cache cache{resource};
+        for (int round = 0; round < rounds; ++round) {
+            for (int i = 0; i < blocksCount; ++i) {
+                int* block = cache.allocate();
+                *block = 1;
+                std::lock_guard lock{mutex};
+                blocks.push_back(block);
+            }
+            while (consumed.load() != (round + 1) * blocksCount) std::this_thread::yield();
+        }
+    });
+    auto consumer = std::thread([&] {
+        resource_t::local_cache cache{resource};
+        while (consumed.load() != rounds * blocksCount) {
+            std::vector<int*> received;
+            {
+                std::lock_guard lock{mutex};
+                received.swap(blocks);
+            }
+            for (int* block : received) {
+                sum += *block;
+                cache.deallocate(block);
+            }
+            consumed += static_cast<int>(received.size());
+            std::this_thread::yield();
+        }
+    });
+    producer.join();
+    consumer.join();
+
+    REQUIRE(sum == rounds * blocksCount);
+    REQUIRE(resource.capacity() <= 2 * blocksCount);
+}
+
+TEST_CASE("block_allocator dynamic growth & trim", "[block_allocator]") {
+    sc::block_allocator_resource<true, int> resource(4);
+    sc::block_allocator<true, int> allocator(resource);
+    REQUIRE(resource.capacity() == 4);
+
+    std::vector<int*> blocks;
+    for (int i = 0; i < 28; ++i) {
+        blocks.push_back(allocator.allocate(1));
+        *blocks.back() = i;
+    }
+    REQUIRE(resource.capacity() == 4 + 8 + 16);
+
+    for (int i = 0; i < 28; i += 2) {
+        allocator.deallocate(blocks[i], 1);
+    }
+    REQUIRE(resource.trim() == 0);
+
+    for (int i = 1; i < 28; i += 2) {
+        allocator.deallocate(blocks[i], 1);
+    }
+    REQUIRE(resource.trim() == 28);
+    REQUIRE(resource.capacity() == 0);
+
+    int* block = allocator.allocate(1);
+    REQUIRE(resource.capacity() == 32);
+    allocator.deallocate(block, 1);
+}
+
+TEST_CASE("block_allocator dynamic huge chunks", "[block_allocator]") {
+    sc::block_allocator_resource<true, int> resource(1 << 20);
+    sc::block_allocator<true, int> allocator(resource);
+
+    int* block = allocator.allocate(1);
+    *block = 42;
+    REQUIRE(resource.trim() == 0);
+    allocator.deallocate(block, 1);
+    REQUIRE(resource.trim() == 1 << 20);
+}
+
+TEST_CASE("block_allocator statistics", "[block_allocator]") {
+    sc::block_allocator_resource<true, int, sc::block_stats::counters> resource(4);
+    sc::block_allocator<true, int, sc::block_stats::counters> allocator(resource);
+
+    int* blocks[6];
+    for (auto& block : blocks) block = allocator.allocate(1);
+    for (int i = 0; i < 3; ++i) allocator.deallocate(blocks[i], 1);
+    blocks[0] = allocator.allocate(1);
+
+    REQUIRE(resource.stats().allocations() == 7);
+    REQUIRE(resource.stats().deallocations() == 3);
+    REQUIRE(resource.stats().peak_size() == 6);
+    REQUIRE(resource.stats().allocation_rate() > 0);
+
+    const auto fill = resource.chunks_fill();
+    REQUIRE(fill.size() == 2);
+    REQUIRE(fill[0] + fill[1] == Approx(2.f / 4 + 2.f / 8));
+
+    static_assert(std::is_empty_v<sc::block_stats::none>);
+#if !defined(NDEBUG)
+    sc::block_allocator_resource<false, int, sc::block_stats::debug> debugResource(4);
+    int* block = debugResource.allocate();
+    debugResource.deallocate(debugResource.allocate());
+    REQUIRE(debugResource.stats().leaks() == 1);
+    debugResource.deallocate(block);
+    REQUIRE(debugResource.stats().leaks() == 0);
+#endif
+}
+
+TEST_CASE("block_pool_allocator node-based containers", "[block_allocator]") {
+    sc::block_pool_resource resource(16);
+
+    std::list<int, sc::block_pool_allocator<int>> list{sc::block_pool_allocator<int>(resource)};
+    using map_allocator_t = sc::block_pool_allocator<std::pair<const int, int>>;
+    std::map<int, int, std::less<>, map_allocator_t> map{map_allocator_t(resource)};
+    std::unordered_map<int, int, std::hash<int>, std::equal_to<>, map_allocator_t> hashMap{map_allocator_t(resource)};
+
+    for (int i = 0; i < 100; ++i) {
+        list.push_back(i);
+        map[i] = i;
+        hashMap[i] = i;
+    }
+    for (int i = 0; i < 100; i += 2) {
+        list.remove(i);
+        map.erase(i);
+        hashMap.erase(i);
+    }
+    REQUIRE(list.size() == 50);
+    REQUIRE(map.size() == 50);
+    REQUIRE(hashMap.at(51) == 51);
+
+    auto copy = map;
+    REQUIRE(copy.get_allocator() == map.get_allocator());
+    REQUIRE(copy.get_allocator().resource() == &resource);
+}
+
+TEST_CASE("block_allocator std::pmr resource", "[block_allocator]") {
+    sc::block_allocator_resource<true, std::array<void*, 4>> blocks(8);
+    sc::block_memory_resource<true, std::array<void*, 4>> resource(blocks);
+
+    std::pmr::list<int> list(&resource);
+    for (int i = 0; i < 20; ++i) list.push_back(i);
+    REQUIRE(blocks.size() == 20);
+
+    std::pmr::vector<int> vec(100, 1, &resource);
+    REQUIRE(blocks.size() == 20);
+    list.clear();
+    REQUIRE(blocks.size() == 0);
+}
+
+TEST_CASE("block_allocator std::pmr resource on an exhausted static resource", "[block_allocator]") {
+    sc::block_allocator_resource<false, std::array<void*, 4>> blocks(4);
+    sc::block_memory_resource<false, std::array<void*, 4>> resource(blocks);
+
+    // The nodes beyond the 4 blocks are allocated upstream
+    std::pmr::list<int> list(&resource);
+    for (int i = 0; i < 8; ++i) list.push_back(i);
+    REQUIRE(blocks.exhausted());
+    REQUIRE(blocks.size() == 4);
+    REQUIRE(list.back() == 7);
+
+    list.pop_front();
+    REQUIRE(!blocks.exhausted());
+    list.push_back(8);
+    REQUIRE(blocks.exhausted());
+
+    list.clear();
+    REQUIRE(blocks.size() == 0);
 }
@@ -3,11 +3,14 @@
 #include <compact_map.hpp>
 #include <make_string.hpp>
 #include <iostream>
+#include <vector>
+#include <algorithm>
+#include <stdexcept>
 
 
 using namespace std::literals;
 
-TEST_CASE("compact_map basics", "[compact_map]") {/* terminate : std::bad_alloc
+TEST_CASE("compact_map basics", "[compact_map]") {
     sc::compact_map<int, std::string> map;
 
     map.reserve(6);
@@ -25,6 +28,210 @@ TEST_CASE("compact_map basics", "[compact_map]") {/* terminate : std::bad_alloc
 
     REQUIRE(map[4].empty());
 
-    REQUIRE(map.erase(map.find(2))->first == 3);*/
+    REQUIRE(map.erase(map.find(2))->first == 3);
+
+    REQUIRE(map.at(3) == "nez");
+    REQUIRE_THROWS_AS(map.at(2), std::out_of_range);
+}
+
+TEST_CASE("compact_map frozen search", "[compact_map]") {
+    sc::compact_map<int, int> map;
+    for (int i = 0; i < 1000; ++i) {
+        map.insert({2 * i, i});
+    }
+
+    map.freeze();
+    REQUIRE(map.is_frozen());
+    for (int i = 0; i < 1000; ++i) {
+        REQUIRE(map.find(2 * i)->second == i);
+        REQUIRE(map.find(2 * i + 1) == map.end());
+    }
+    REQUIRE(map.find(-1) == map.end());
+    REQUIRE(map.at(42) == 21);
+
+    // Modifications go back to the sorted vector search
+    map[1] = -1;
+    REQUIRE(!map.is_frozen());
+    REQUIRE(map.find(1)->second == -1);
+
+    map.freeze();
+    REQUIRE(map.find(1)->second == -1);
+    REQUIRE(map.find(1998)->second == 999);
+
+    // Every tree shape of small maps
+    for (int size = 0; size < 20; ++size) {
+        sc::compact_map<int, int> small;
+        for (int i = 0; i < size; ++i) {
+            small.insert({i, i});
+        }
+        small.freeze();
+        for (int i = -1; i <= size; ++i) {
+            REQUIRE((small.find(i) != small.end()) == (i >= 0 && i < size));
+        }
+    }
+}
+
+TEST_CASE("compact_map bulk insertions", "[compact_map]") {
+    sc::compact_map<int, std::string> map;
+    map.insert({2, "two"s});
+
+    const std::vector<std::pair<const int, std::string>> values = {
+        {5, "five"s}, {1, "one"s}, {2, "duplicate"s}, {3, "three"s}, {1, "duplicate"s}
+    };
+    map.insert(values.begin(), values.end());
+
+    REQUIRE(map.size() == 4);
+    REQUIRE(map.at(1) == "one");
+    REQUIRE(map.at(2) == "two");
+    REQUIRE(std::is_sorted(map.cbegin(), map.cend(), [] (auto const& v1, auto const& v2) { return v1.first < v2.first; }));
+
+    const std::vector<std::pair<const int, std::string>> sorted = { {0, "zero"s}, {3, "other"s}, {4, "four"s} };
+    auto other = sc::compact_map<int, std::string>::from_sorted_unique(sorted.begin(), sorted.end());
+    REQUIRE(other.size() == 3);
+    REQUIRE(other.at(4) == "four");
+
+    map.merge(other);
+    REQUIRE(map.size() == 6);
+    REQUIRE(map.at(0) == "zero");
+    REQUIRE(map.at(3) == "three");
+    REQUIRE(map.begin()->first == 0);
+    REQUIRE(map.crbegin()->first == 5);
+
+    map.merge(map);
+    REQUIRE(map.size() == 6);
+}
+
+namespace {
+    struct throwing_copy_t {
+        explicit throwing_copy_t(int val = 0) : val(val) {}
+        throwing_copy_t(throwing_copy_t const& clone) : val(clone.val) {
+            if (val < 0) throw std::runtime_error("throwing_copy_t copy");
+        }
+        throwing_copy_t& operator=(throwing_copy_t const&) = default;
+        int val;
+    };
+}
+
+TEST_CASE("compact_map bulk insertions exception safety", "[compact_map]") {
+    sc::compact_map<int, throwing_copy_t> map;
+    map.insert({2, throwing_copy_t(2)});
+
+    std::vector<std::pair<const int, throwing_copy_t>> values;
+    values.reserve(3);
+    values.emplace_back(3, 3);
+    values.emplace_back(1, -1);
+    values.emplace_back(0, 0);
+
+    REQUIRE_THROWS_AS(map.insert(values.begin(), values.end()), std::runtime_error);
+    REQUIRE(map.size() == 1);
+    REQUIRE(map.at(2).val == 2);
+
+    map.insert(values.begin(), values.begin() + 1);
+    REQUIRE(map.size() == 2);
+    REQUIRE(map.at(3).val == 3);
+}
+
+TEST_CASE("split_compact_map", "[compact_map]") {
+    sc::split_compact_map<std::string, int> map;
+    REQUIRE(map.insert(std::make_pair("two"s, 2)).second);
+    REQUIRE(!map.insert(std::make_pair("two"s, -2)).second);
+    map["one"] = 1;
+    REQUIRE(map.at("two") == 2);
+    REQUIRE(map.find("three") == map.end());
+    REQUIRE(map.begin()->first == "one");
+    REQUIRE(map.keys()[1] == "two");
+
+    map.erase(map.find("one"));
+    REQUIRE(map.size() == 1);
+    REQUIRE((*map.begin()).second == 2);
+
+    // Integer keys, searched with SIMD in the last window
+    sc::split_compact_map<int, int> ints;
+    const std::vector<std::pair<int, int>> values = { {3, 3}, {1, 1}, {2, 2}, {1, -1} };
+    ints.insert(values.begin(), values.end());
+    REQUIRE(ints.size() == 3);
+    REQUIRE(ints.at(1) == 1);
+
+    std::vector<std::pair<int, int>> many;
+    for (int i = 0; i < 1000; ++i) {
+        many.emplace_back(2 * i, i);
+    }
+    ints.insert(many.begin(), many.end());
+    REQUIRE(ints.size() == 1002);
+    REQUIRE(ints.at(2) == 2);
+    for (int i = 0; i < 1000; ++i) {
+        REQUIRE(ints.find(2 * i)->second == (i == 1 ? 2 : i));
+        REQUIRE((ints.find(2 * i + 1) != ints.end()) == (i == 0 || i == 1));
+    }
+    REQUIRE(ints.find(-1) == ints.end());
+    REQUIRE(ints.find(2000) == ints.end());
+
+    int sum = 0;
+    for (auto it = ints.cbegin(); it != ints.cend(); ++it) {
+        sum += it.value();
+    }
+    REQUIRE(sum == 999 * 1000 / 2 + 1 + 3 + 2 - 1);
 }
 
+TEST_CASE("split_compact_map insertions", "[compact_map]") {
+    sc::split_compact_map<int, std::string> map;
+    REQUIRE(map.insert({1, "one"s}).second);
+    const std::pair<const int, std::string> two{2, "two"s};
+    REQUIRE(map.insert(two).second);
+    REQUIRE(map.at(2) == "two");
+
+    // A throwing value insertion doesn't leave its key in the map
+    sc::split_compact_map<int, throwing_copy_t> throwing;
+    throwing.insert({2, throwing_copy_t(2)});
+    const std::pair<const int, throwing_copy_t> invalid(1, -1);
+    REQUIRE_THROWS_AS(throwing.insert(invalid), std::runtime_error);
+    REQUIRE(throwing.size() == 1);
+    REQUIRE(throwing.find(1) == throwing.end());
+    REQUIRE(throwing.at(2).val == 2);
+}
+
+namespace {
+    // Moves throw once the countdown reaches zero (if not negative), moved-from values are -1
+    struct throwing_move_t {
+        static inline int movesBeforeThrow = -1;
+
+        explicit throwing_move_t(int val = 0) : val(val) {}
+        throwing_move_t(throwing_move_t const&) = default;
+        throwing_move_t(throwing_move_t&& moved) : val(moved.val) {
+            if (movesBeforeThrow >= 0 && movesBeforeThrow-- == 0) throw std::runtime_error("throwing_move_t move");
+            moved.val = -1;
+        }
+        throwing_move_t& operator=(throwing_move_t const&) = default;
+        throwing_move_t& operator=(throwing_move_t&&) = default;
+        int val;
+    };
+}
+
+TEST_CASE("split_compact_map bulk insertions exception safety", "[compact_map]") {
+    sc::split_compact_map<int, throwing_move_t> map;
+    for (int key : {1, 3, 5}) map.insert({key, throwing_move_t(key)});
+
+    std::vector<std::pair<int, throwing_move_t>> values;
+    values.reserve(3);
+    for (int key : {4, 2, 3}) values.emplace_back(key, key);
+
+    // Throws at each move in turn, the map is either unchanged or holds all the keys
+    bool inserted = false;
+    for (int moves = 0; !inserted; ++moves) {
+        throwing_move_t::movesBeforeThrow = moves;
+        try {
+            map.insert(values.begin(), values.end());
+            inserted = true;
+        }
+        catch (std::runtime_error const&) {
+            REQUIRE(map.size() == 3);
+            for (int key : {1, 3, 5}) REQUIRE(map.at(key).val == key);
+        }
+    }
+    throwing_move_t::movesBeforeThrow = -1;
+
+    REQUIRE(map.size() == 5);
+    for (int key = 1; key <= 5; ++key) {
+        REQUIRE(map.at(key).val == key);
+    }
+}
@@ -0,0 +1,79 @@
+#include "catch.hpp"
+
+// POSIX only
+#if defined(__unix__) || defined(__APPLE__)
+
+#include <mapped_pod_vector.hpp>
+#include <cstdio>
+#include <numeric>
+#include <limits>
+
+
+namespace {
+    struct record_t {
+        int id;
+        float value;
+    };
+}
+
+TEST_CASE("mapped_pod_vector read & write", "[mapped_pod_vector]") {
+    const std::string path = "tests_mapped_pod_vector.bin";
+    std::remove(path.c_str());
+    {
+        sc::mapped_pod_vector<record_t> records(path, sc::map_mode::read_write);
+        REQUIRE(records.is_open());
+        REQUIRE(records.empty());
+
+        records.resize(1000);
+        for (int i = 0; i < records.size(); ++i) {
+            records[i] = {i, i * 0.5f};
+        }
+        records.resize(2000);
+        REQUIRE(records[999].id == 999);
+        REQUIRE(records[1999].id == 0);
+
+        records.resize(1000);
+        records.sync();
+    }
+    {
+        using namespace sc::flag_operators;
+        sc::mapped_pod_vector<record_t> records(path, sc::map_mode::read_only,
+                                                sc::map_hints::populate | sc::map_hints::sequential);
+        REQUIRE(records.size() == 1000);
+        REQUIRE(records[500].value == 250.f);
+
+        const auto ids = std::accumulate(records.begin(), records.end(), 0ll, [] (long long sum, record_t const& r) {
+            return sum + r.id;
+        });
+        REQUIRE(ids == 999 * 1000 / 2);
+
+        auto moved = std::move(records);
+        REQUIRE(!records.is_open());
+        REQUIRE(moved.back().id == 999);
+    }
+    std::remove(path.c_str());
+
+    REQUIRE_THROWS_AS(sc::mapped_pod_vector<record_t>(path), std::system_error);
+}
+
+TEST_CASE("mapped_pod_vector too many values", "[mapped_pod_vector]") {
+    const std::string path = "tests_mapped_pod_vector_big.bin";
+    std::remove(path.c_str());
+    {
+        sc::mapped_pod_vector<char> bytes(path, sc::map_mode::read_write);
+        REQUIRE_THROWS_AS(bytes.resize(-1), std::system_error);
+    }
+
+    // Sparse file, one byte over the maximal int size
+    REQUIRE(::truncate(path.c_str(), static_cast<off_t>(std::numeric_limits<int>::max()) + 1) == 0);
+    try {
+        sc::mapped_pod_vector<char> bytes(path);
+        FAIL("The values count must not be truncated");
+    }
+    catch (std::system_error const& error) {
+        REQUIRE(error.code().value() == EOVERFLOW);
+    }
+    std::remove(path.c_str());
+}
+
+#endif
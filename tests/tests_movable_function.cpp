@@ -1,6 +1,10 @@
 
 #include "catch.hpp"
 #include <movable_function.hpp>
+#include <stack_allocator.hpp>
+#include <spsc_queue.hpp>
+#include <lazy_ranges.hpp>
+#include <vector>
 #include <functional>
 
 namespace {
@@ -20,6 +24,9 @@ TEST_CASE("movable_function type erasure", "[movable_function]") {
         return *pName;
     });
     REQUIRE(make_name_f() == name);
+
+    using fun_t = void (*) (int&);
+    REQUIRE(!sc::movable_function<void(int&)>{static_cast<fun_t>(nullptr)}.is_valid());
 }
 
 namespace {
@@ -52,5 +59,103 @@ TEST_CASE("movable_function move operations", "[movable_function]") {
     sc::movable_function<int()> wrapper2;
     wrapper2 = std::move(wrapper);
 
-    REQUIRE(wrapper2() == 1);
+    // Dummy is stored inline : moved into the temporary, into wrapper then into wrapper2
+    REQUIRE(wrapper2() == 3);
+}
+
+namespace {
+    struct RelocatableDummy : Dummy {};
+}
+namespace sc {
+    template<> constexpr bool is_trivially_relocatable<RelocatableDummy> = true;
+}
+
+TEST_CASE("movable_function relocation", "[movable_function]") {
+    sc::movable_function<int()> wrapper(RelocatableDummy{});
+    auto wrapper2 = std::move(wrapper);
+    wrapper = std::move(wrapper2);
+
+    // Moved once into the storage, then relocated without calling the move constructor
+    REQUIRE(wrapper() == 1);
+}
+
+namespace {
+    struct Big {
+        long long values[8];
+        long long operator()() const { return values[7]; }
+    };
+}
+
+TEST_CASE("movable_function inline storage", "[movable_function]") {
+    static_assert(sizeof(sc::movable_function<int()>) == sizeof(void*) + sc::movable_function<int()>::inline_size);
+
+    int counter = 0;
+    sc::movable_function<int()> small([&counter] { return ++counter; });
+    sc::movable_function<long long()> big(Big{{0, 1, 2, 3, 4, 5, 6, 7}});
+
+    auto small2 = std::move(small);
+    auto big2 = std::move(big);
+    REQUIRE(!small);
+    REQUIRE(!big);
+    REQUIRE(small2() == 1);
+    REQUIRE(big2() == 7);
+
+    swap(small, small2);
+    REQUIRE(small() == 2);
+    REQUIRE(!small2);
+
+    auto shared = std::make_shared<int>(3);
+    {
+        sc::movable_function<int(), 4 * sizeof(void*)> wrapper([shared] { return *shared; });
+        REQUIRE(shared.use_count() == 2);
+        REQUIRE(wrapper() == 3);
+    }
+    REQUIRE(shared.use_count() == 1);
+}
+
+TEST_CASE("movable_function custom allocator", "[movable_function]") {
+    sc::stack_resource stack(1024);
+    {
+        sc::stack_guard guard{ stack };
+        sc::movable_function<long long()> big(std::allocator_arg, guard.get_allocator<char>(), Big{{0, 1, 2, 3, 4, 5, 6, 7}});
+        const int bigSize = stack.size();
+        REQUIRE(bigSize >= sizeof(Big));
+
+        auto big2 = std::move(big);
+        REQUIRE(big2() == 7);
+
+        sc::movable_function<int()> small(std::allocator_arg, guard.get_allocator<char>(), [] { return 1; });
+        REQUIRE(stack.size() == bigSize);
+        REQUIRE(small() == 1);
+    }
+    REQUIRE(stack.size() == 0);
+}
+
+TEST_CASE("function_ref", "[movable_function]") {
+    static_assert(sizeof(sc::function_ref<int()>) == 2 * sizeof(void*));
+
+    int val = 2;
+    sc::function_ref<void(int&)> inc_f = increment;
+    inc_f(val);
+    REQUIRE(val == 3);
+
+    int sum = 0;
+    auto add = [&sum] (int i) { sum += i; };
+    sc::function_ref<void(int)> add_f = add;
+    auto add_f2 = add_f;
+    add_f(1);
+    add_f2(2);
+    REQUIRE(sum == 3);
+
+    // Used as a callback without instantiating the consumers for each lambda
+    sc::spsc_queue<int> queue(4);
+    queue.push(3);
+    queue.push(4);
+    REQUIRE(queue.consume_all(sc::function_ref<void(int&&)>(add)) == 2);
+    REQUIRE(sum == 10);
+
+    std::vector<int> vec{1, 2, 3};
+    auto twice = [] (int i) { return 2 * i; };
+    auto found = sc::lazy_range(vec).map(sc::function_ref<int(int)>(twice)).find(4);
+    REQUIRE(found);
 }
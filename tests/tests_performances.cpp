@@ -5,8 +5,17 @@
 #include <lazy_ranges.hpp>
 #include <fluent_collections.hpp>
 #include <pod_vector.hpp>
+#include <small_pod_vector.hpp>
+#include <simd_algorithms.hpp>
+#include <compact_map.hpp>
+#include <movable_function.hpp>
+#include <block_allocator.hpp>
 
 #include <chrono>
+#include <cstring>
+#include <iostream>
+#include <map>
+#include <numeric>
 #include <functional>
 #include <mutex>
 #include <thread>
@@ -250,3 +259,299 @@ TEST_CASE("pod_vector vs std::vector (bytes)", "[.][performances]") {
     std::cout << "\n pod_vector resize and copies :  " << times[1];
     std::cout << "\n";
 }
+
+TEST_CASE("block_allocator_resource startup (1 GiB pool)", "[.][performances]") {
+    struct alignas(64) node_t { std::byte data[64]; };
+    constexpr auto nodesCount = static_cast<int>((size_t(1) << 30) / sizeof(node_t));
+
+    auto times = mesure_tasks({
+        [=] {
+            sc::block_allocator_resource<false, node_t> resource(nodesCount);
+            resource.deallocate(resource.allocate());
+        },
+        [=] {
+            sc::block_allocator_resource<true, node_t> resource(nodesCount);
+            resource.deallocate(resource.allocate());
+        },
+        [=] { // Touch every page, as a free list threaded at construction does
+            sc::pod_vector<node_t> blocks(nodesCount);
+            std::memset(blocks.data(), 0, blocks.size() * sizeof(node_t));
+        }
+    }, 3);
+
+    std::cout << "\n       +------------------------------------------+";
+    std::cout << "\n       | block_allocator_resource startup (1 GiB) |";
+    std::cout << "\n       +------------------------------------------+";
+    std::cout << "\n";
+    std::cout << "\n static resource construction :  " << times[0];
+    std::cout << "\n dynamic resource construction : " << times[1];
+    std::cout << "\n touching the whole pool :       " << times[2];
+    std::cout << "\n";
+}
+
+TEST_CASE("std::map with block_pool_allocator vs std::allocator", "[.][performances]") {
+    using pool_allocator_t = sc::block_pool_allocator<std::pair<const int, int>>;
+    constexpr int nodesCount(100'000);
+
+    auto map_task = [] (auto map) {
+        for (int i = 0; i < nodesCount; ++i) map.emplace(i, i);
+        for (int i = 0; i < nodesCount; i += 2) map.erase(i);
+        for (int i = 0; i < nodesCount; i += 2) map.emplace(i, i);
+        map.clear();
+    };
+
+    sc::block_pool_resource resource(4'096);
+    auto times = mesure_tasks({
+        [=] { map_task(std::map<int, int>{}); },
+        [&] { map_task(std::map<int, int, std::less<>, pool_allocator_t>{pool_allocator_t(resource)}); }
+    });
+
+    std::cout << "\n       +--------------------------------------------+";
+    std::cout << "\n       | std::map block_pool_allocator vs allocator |";
+    std::cout << "\n       +--------------------------------------------+";
+    std::cout << "\n";
+    std::cout << "\n std::allocator inserts and erases :       " << times[0];
+    std::cout << "\n block_pool_allocator inserts and erases : " << times[1];
+    std::cout << "\n";
+}
+
+TEST_CASE("movable_function vs std::function vs function pointer calls", "[.][performances]") {
+    constexpr int callsCount(10'000'000);
+
+    auto call_task = [] (auto& f) {
+        volatile int val = 0;
+        for (int i = 0; i < callsCount; ++i) {
+            val = f(int(val));
+        }
+    };
+
+    int (*pointer)(int) = [] (int val) { return val + 1; };
+    std::function<int(int)> stdFunction = [] (int val) { return val + 1; };
+    sc::movable_function<int(int)> movableFunction = [] (int val) { return val + 1; };
+
+    auto times = mesure_tasks({
+        [&] { call_task(pointer); },
+        [&] { call_task(stdFunction); },
+        [&] { call_task(movableFunction); }
+    });
+
+    std::cout << "\n       +----------------------------------------------+";
+    std::cout << "\n       | movable_function vs std::function vs fun_ptr |";
+    std::cout << "\n       +----------------------------------------------+";
+    std::cout << "\n";
+    std::cout << "\n function pointer calls :  " << times[0];
+    std::cout << "\n std::function calls :     " << times[1];
+    std::cout << "\n sc::movable_function calls : " << times[2];
+    std::cout << "\n";
+}
+
+TEST_CASE("pod_vector growth with realloc_allocator vs std::allocator", "[.][performances]") {
+    constexpr int valuesCount = (256 << 20) / sizeof(int);
+
+    auto grow_task = [] (auto vec) {
+        for (int i = 0; i < valuesCount; ++i) {
+            vec.emplace_back(i);
+        }
+        REQUIRE(vec.back() == valuesCount - 1);
+    };
+
+    auto times = mesure_tasks({
+        [=] { grow_task(sc::pod_vector<int>{}); },
+        [=] { grow_task(sc::pod_vector<int, sc::realloc_allocator<int>>{}); }
+    }, 5);
+
+    std::cout << "\n       +-----------------------------------------+";
+    std::cout << "\n       | pod_vector growth up to 256 MiB of ints |";
+    std::cout << "\n       +-----------------------------------------+";
+    std::cout << "\n";
+    std::cout << "\n std::allocator :        " << times[0];
+    std::cout << "\n sc::realloc_allocator : " << times[1];
+    std::cout << "\n";
+}
+
+TEST_CASE("small_pod_vector vs pod_vector for small vectors", "[.][performances]") {
+    constexpr int vectorsCount(1'000'000);
+
+    auto small_task = [] (auto make_vector) {
+        long long sum = 0;
+        for (int i = 0; i < vectorsCount; ++i) {
+            auto vec = make_vector();
+            for (int j = 0; j < 12; ++j) {
+                vec.emplace_back(i + j);
+            }
+            sum += vec.back();
+        }
+        REQUIRE(sum > 0);
+    };
+
+    auto times = mesure_tasks({
+        [=] { small_task([] { sc::pod_vector<int> vec; vec.reserve(16); return vec; }); },
+        [=] { small_task([] { return sc::small_pod_vector<int, 16>{}; }); }
+    });
+
+    std::cout << "\n       +--------------------------------------+";
+    std::cout << "\n       | 12 elements pod_vector vs small one  |";
+    std::cout << "\n       +--------------------------------------+";
+    std::cout << "\n";
+    std::cout << "\n sc::pod_vector :           " << times[0];
+    std::cout << "\n sc::small_pod_vector<16> : " << times[1];
+    std::cout << "\n";
+}
+
+TEST_CASE("simd_algorithms vs std algorithms", "[.][performances]") {
+    constexpr int valuesCount(10'000'000);
+
+    sc::pod_vector<int> ints(valuesCount);
+    sc::pod_vector<float> floats(valuesCount);
+    for (int i = 0; i < valuesCount; ++i) {
+        ints[i] = i % 1000;
+        floats[i] = static_cast<float>(i % 1000);
+    }
+    volatile long long result = 0;
+
+    auto times = mesure_tasks({
+        [&] { result = std::accumulate(ints.begin(), ints.end(), 0); },
+        [&] { result = sc::simd::sum(ints); },
+        [&] { result = std::count(ints.begin(), ints.end(), 42); },
+        [&] { result = sc::simd::count(ints, 42); },
+        [&] { result = static_cast<long long>(*std::min_element(floats.begin(), floats.end())); },
+        [&] { result = static_cast<long long>(sc::simd::min(floats)); },
+        [&] { result = std::find(ints.begin(), ints.end(), -1) - ints.begin(); },
+        [&] { result = sc::simd::find(ints, -1); }
+    });
+
+    std::cout << "\n       +-----------------------------------+";
+    std::cout << "\n       | simd_algorithms vs std algorithms |";
+    std::cout << "\n       +-----------------------------------+";
+    std::cout << "\n";
+    std::cout << "\n std::accumulate (int) :    " << times[0];
+    std::cout << "\n sc::simd::sum (int) :      " << times[1];
+    std::cout << "\n std::count (int) :         " << times[2];
+    std::cout << "\n sc::simd::count (int) :    " << times[3];
+    std::cout << "\n std::min_element (float) : " << times[4];
+    std::cout << "\n sc::simd::min (float) :    " << times[5];
+    std::cout << "\n std::find (int) :          " << times[6];
+    std::cout << "\n sc::simd::find (int) :     " << times[7];
+    std::cout << "\n";
+}
+
+TEST_CASE("compact_map sorted vs frozen search", "[.][performances]") {
+    constexpr int keysCount(4'000'000);
+    constexpr int searchesCount(1'000'000);
+
+    // Keys inserted in order are appended
+    sc::compact_map<int, int> map;
+    map.reserve(keysCount);
+    for (int i = 0; i < keysCount; ++i) {
+        map.insert({2 * i, i});
+    }
+    sc::compact_map<int, int> frozenMap = map;
+    frozenMap.freeze();
+
+    std::vector<int> keys(searchesCount);
+    unsigned random = 42;
+    for (int& key : keys) {
+        random = random * 1103515245u + 12345u;
+        key = static_cast<int>(random % (2u * keysCount));
+    }
+
+    auto search_task = [&keys] (sc::compact_map<int, int> const& map) {
+        int found = 0;
+        for (int key : keys) {
+            found += map.find(key) != map.cend();
+        }
+        REQUIRE(found > 0);
+    };
+
+    auto times = mesure_tasks({
+        [&] { search_task(map); },
+        [&] { search_task(frozenMap); }
+    });
+
+    std::cout << "\n       +-----------------------------------------+";
+    std::cout << "\n       | compact_map of 4M keys, 1M random finds |";
+    std::cout << "\n       +-----------------------------------------+";
+    std::cout << "\n";
+    std::cout << "\n sorted vector search : " << times[0];
+    std::cout << "\n frozen (Eytzinger) :   " << times[1];
+    std::cout << "\n";
+}
+
+TEST_CASE("compact_map insert one by one vs bulk insert", "[.][performances]") {
+    constexpr int keysCount(100'000);
+
+    std::vector<std::pair<const int, int>> values;
+    values.reserve(keysCount);
+    unsigned random = 42;
+    for (int i = 0; i < keysCount; ++i) {
+        random = random * 1103515245u + 12345u;
+        values.emplace_back(static_cast<int>(random >> 1), i);
+    }
+
+    auto times = mesure_tasks({
+        [&] {
+            sc::compact_map<int, int> map;
+            for (auto const& val : values) map.insert(val);
+            REQUIRE(map.size() > 0);
+        },
+        [&] {
+            sc::compact_map<int, int> map;
+            map.insert(values.begin(), values.end());
+            REQUIRE(map.size() > 0);
+        }
+    }, 3);
+
+    std::cout << "\n       +-----------------------------------------+";
+    std::cout << "\n       | compact_map building from 100k randoms  |";
+    std::cout << "\n       +-----------------------------------------+";
+    std::cout << "\n";
+    std::cout << "\n insert one by one : " << times[0];
+    std::cout << "\n bulk insert :       " << times[1];
+    std::cout << "\n";
+}
+
+TEST_CASE("compact_map vs split_compact_map search", "[.][performances]") {
+    constexpr int keysCount(1'000'000);
+    constexpr int searchesCount(1'000'000);
+
+    struct value_t {
+        long long data[7];
+    };
+
+    std::vector<std::pair<const int, value_t>> values;
+    values.reserve(keysCount);
+    for (int i = 0; i < keysCount; ++i) {
+        values.push_back({2 * i, value_t{{i}}});
+    }
+    auto map = sc::compact_map<int, value_t>::from_sorted_unique(values.begin(), values.end());
+    sc::split_compact_map<int, value_t> splitMap;
+    splitMap.insert(values.begin(), values.end());
+
+    std::vector<int> keys(searchesCount);
+    unsigned random = 42;
+    for (int& key : keys) {
+        random = random * 1103515245u + 12345u;
+        key = static_cast<int>(random % (2u * keysCount));
+    }
+
+    auto search_task = [&keys] (auto const& map) {
+        int found = 0;
+        for (int key : keys) {
+            found += map.find(key) != map.cend();
+        }
+        REQUIRE(found > 0);
+    };
+
+    auto times = mesure_tasks({
+        [&] { search_task(map); },
+        [&] { search_task(splitMap); }
+    });
+
+    std::cout << "\n       +-----------------------------------------------+";
+    std::cout << "\n       | 1M keys with 56 bytes values, 1M random finds |";
+    std::cout << "\n       +-----------------------------------------------+";
+    std::cout << "\n";
+    std::cout << "\n sc::compact_map :       " << times[0];
+    std::cout << "\n sc::split_compact_map : " << times[1];
+    std::cout << "\n";
+}
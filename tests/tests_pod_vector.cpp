@@ -2,6 +2,12 @@
 #include "catch.hpp"
 #include "pod_vector.hpp"
 
+#include <memory>
+#include <string>
+#include <cstring>
+#include <algorithm>
+#include <limits>
+
 
 TEST_CASE("pod_vector correctness", "[pod_vector]") {
     sc::pod_vector<char> vec(10);
@@ -18,6 +24,137 @@ TEST_CASE("pod_vector correctness", "[pod_vector]") {
     REQUIRE(vec3.capacity() == 11);
 }
 
+namespace {
+    // Has a non trivial move, but doesn't depend on its own address
+    struct relocatable_t {
+        explicit relocatable_t(int val) : val(val) {}
+        relocatable_t(relocatable_t&& moved) noexcept : val(moved.val) { moved.val = -1; }
+        int val;
+    };
+    // Copies are counted, so pod_vector must call the copy constructor
+    struct copy_counted_t {
+        explicit copy_counted_t(int val) : val(val) {}
+        copy_counted_t(copy_counted_t const& clone) : val(clone.val), copies(clone.copies + 1) {}
+        int val;
+        int copies = 0;
+    };
+}
+namespace sc {
+    template<> constexpr bool is_trivially_relocatable<relocatable_t> = true;
+    template<> constexpr bool is_trivially_relocatable<copy_counted_t> = true;
+}
+
+TEST_CASE("pod_vector relocation", "[pod_vector]") {
+    static_assert(!std::is_trivially_copyable_v<relocatable_t>);
+
+    sc::pod_vector<relocatable_t> vec(0);
+    vec.reserve(1);
+    for (int i = 0; i < 100; ++i) {
+        vec.emplace_back(i);
+    }
+
+    REQUIRE(vec.size() == 100);
+    for (int i = 0; i < 100; ++i) {
+        REQUIRE(vec[i].val == i);
+    }
+}
+
+TEST_CASE("pod_vector copy of non trivially copyable values", "[pod_vector]") {
+    sc::pod_vector<copy_counted_t> vec;
+    for (int i = 0; i < 10; ++i) {
+        vec.emplace_back(i);
+    }
+
+    auto vec2 = vec;
+    REQUIRE(vec2.size() == 10);
+    REQUIRE(vec2[9].val == 9);
+    REQUIRE(vec2[9].copies == 1);
+
+    vec2.append(vec.data(), vec.size());
+    vec = vec2;
+    REQUIRE(vec.size() == 20);
+    REQUIRE(vec[0].copies == 2);
+    REQUIRE(vec[19].copies == 2);
+}
+
+TEST_CASE("pod_vector growth policies", "[pod_vector]") {
+    sc::pod_vector<int, std::allocator<int>, sc::growth_policy::one_and_half> vec(10);
+    vec.emplace_back();
+    REQUIRE(vec.capacity() == 15);
+
+    sc::pod_vector<int, std::allocator<int>, sc::growth_policy::page_rounded> vec2;
+    vec2.emplace_back();
+    REQUIRE(vec2.capacity() == 4096 / sizeof(int));
+
+    sc::pod_vector<char> vec3;
+    vec3.emplace_back('a');
+    REQUIRE(vec3.capacity() == 1);
+}
+
+TEST_CASE("pod_vector growth policies near the maximal capacity", "[pod_vector]") {
+    namespace growth = sc::growth_policy;
+    constexpr int max = std::numeric_limits<int>::max();
+
+    REQUIRE(growth::doubling::next_capacity(max / 2 + 1, max / 2 + 2, 4) == max);
+    REQUIRE(growth::one_and_half::next_capacity(max - 10, max - 5, 4) == max);
+    REQUIRE(growth::one_and_half::next_capacity(max / 2, max / 2 + 1, 4) == max / 2 + max / 4);
+    REQUIRE(growth::page_rounded::next_capacity(max - 1, max, 1) == max);
+    REQUIRE(growth::page_rounded::next_capacity(max / 2 + 1, max / 2 + 2, 16) == max);
+    REQUIRE(growth::page_rounded::next_capacity(max / 4, max / 4 + 1, 16) == max / 2 + 1);
+}
+
+TEST_CASE("pod_vector realloc_allocator", "[pod_vector]") {
+    constexpr int valuesCount = 2 * sc::realloc_allocator<int>::mmap_threshold_bytes / sizeof(int);
+
+    // Goes from malloc to mmap, then is remapped
+    sc::pod_vector<int, sc::realloc_allocator<int>> vec;
+    for (int i = 0; i < valuesCount; ++i) {
+        vec.emplace_back(i);
+    }
+    REQUIRE(vec.size() == valuesCount);
+    REQUIRE(vec[valuesCount / 2] == valuesCount / 2);
+    REQUIRE(vec.back() == valuesCount - 1);
+
+    vec.resize(10);
+    vec.shrink_to_fit();
+    REQUIRE(vec.capacity() == 10);
+    REQUIRE(vec[9] == 9);
+}
+
+TEST_CASE("pod_vector bulk operations", "[pod_vector]") {
+    const char hello[] = "hello";
+    const char world[] = " world";
+
+    sc::pod_vector<char> vec;
+    vec.append(hello, 5);
+    vec.append(world, 6);
+    REQUIRE(std::string(vec.data(), vec.size()) == "hello world");
+
+    auto it = vec.erase(vec.begin() + 1, vec.begin() + 5);
+    REQUIRE(*it == ' ');
+    REQUIRE(std::string(vec.data(), vec.size()) == "h world");
+
+    const std::string ello = "ello";
+    it = vec.insert(vec.begin() + 1, ello.begin(), ello.end());
+    REQUIRE(*it == 'e');
+    REQUIRE(std::string(vec.data(), vec.size()) == "hello world");
+
+    vec.insert(vec.end(), hello, hello + 1);
+    REQUIRE(vec.back() == 'h');
+
+    vec.assign(world + 1, world + 6);
+    REQUIRE(std::string(vec.data(), vec.size()) == "world");
+
+    const int size = vec.size();
+    vec.resize_uninitialized(size + 100);
+    REQUIRE(vec.capacity() >= size + 100);
+    std::memset(vec.data() + size, '!', 100);
+    REQUIRE(vec.back() == '!');
+
+    auto vec2 = vec;
+    REQUIRE(std::equal(vec.begin(), vec.end(), vec2.begin()));
+}
+
 TEST_CASE("pod_vector performances", "[pod_vector]") {
 
 }
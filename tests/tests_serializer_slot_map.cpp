@@ -0,0 +1,93 @@
+
+#include "catch.hpp"
+#include <serializer_slot_map.hpp>
+#include <vector>
+
+
+TEST_CASE("serializer_slot_map trivially copyable values", "[serializer_slot_map]") {
+    constexpr int dataCount(10);
+
+    sc::slot_map<int32_t> map;
+    sc::slot_map<int32_t>::key keys[dataCount];
+    for (int i = 0; i < dataCount; ++i) {
+        keys[i] = map.emplace(i * 10);
+    }
+    for (int i = 0; i < dataCount; i += 2) {
+        map.erase(keys[i]);
+    }
+
+    std::vector<std::byte> storage(static_cast<size_t>(sc::serialized_size(map)));
+    sc::binary_span span{storage.data(), storage.data() + storage.size()};
+    span << map;
+    REQUIRE(span.begin == storage.data() + storage.size());
+
+    sc::slot_map<int32_t> restored;
+    span.begin = storage.data();
+    span >> restored;
+
+    REQUIRE(restored.size() == map.size());
+    for (int i = 1; i < dataCount; i += 2) {
+        REQUIRE(restored[keys[i]] == i * 10);
+    }
+    REQUIRE(!restored.try_get(keys[0]));
+
+    auto newKey = restored.emplace(42);
+    REQUIRE(restored[newKey] == 42);
+}
+
+namespace {
+    struct counted {
+        int32_t value = 0;
+        explicit counted(int32_t v = 0) : value(v) {}
+        counted(counted const& clone) noexcept : value(clone.value) {}
+        counted& operator=(counted const& clone) noexcept { value = clone.value; return *this; }
+    };
+    template<class Span>
+    auto &operator&(Span &span, counted &c) {
+        return span & c.value;
+    }
+}
+
+TEST_CASE("serializer_slot_map values serialized one by one", "[serializer_slot_map]") {
+    static_assert(!std::is_trivially_copyable_v<counted>);
+
+    sc::slot_map<counted> map;
+    auto key1 = map.emplace(1);
+    auto key2 = map.emplace(2);
+    auto key3 = map.emplace(3);
+    map.erase(key2);
+
+    std::vector<std::byte> storage(static_cast<size_t>(sc::serialized_size(map)));
+    sc::binary_span span{storage.data(), storage.data() + storage.size()};
+    span << map;
+    REQUIRE(span.begin == storage.data() + storage.size());
+
+    sc::slot_map<counted> restored;
+    span.begin = storage.data();
+    span >> restored;
+
+    REQUIRE(restored.size() == 2);
+    REQUIRE(restored[key1].value == 1);
+    REQUIRE(restored[key3].value == 3);
+    REQUIRE(!restored.try_get(key2));
+}
+
+TEST_CASE("serializer_slot_map empty map", "[serializer_slot_map]") {
+    sc::slot_map<int32_t> map;
+
+    std::vector<std::byte> storage(static_cast<size_t>(sc::serialized_size(map)));
+    REQUIRE(storage.size() == 3 * sizeof(int32_t));
+    sc::binary_span span{storage.data(), storage.data() + storage.size()};
+    span << map;
+    REQUIRE(span.begin == storage.data() + storage.size());
+
+    sc::slot_map<int32_t> restored;
+    restored.emplace(1);
+    span.begin = storage.data();
+    span >> restored;
+    REQUIRE(span.begin == storage.data() + storage.size());
+    REQUIRE(restored.size() == 0);
+
+    auto key = restored.emplace(42);
+    REQUIRE(restored[key] == 42);
+}
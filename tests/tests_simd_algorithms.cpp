@@ -0,0 +1,50 @@
+#include "catch.hpp"
+#include "simd_algorithms.hpp"
+
+#include <algorithm>
+#include <numeric>
+#include <vector>
+
+
+namespace {
+    template <class TestType>
+    void check_against_std() {
+        // Odd size to go through the scalar tails
+        constexpr int size = 1001;
+
+        sc::pod_vector<TestType> vec(size);
+        for (int i = 0; i < size; ++i) {
+            vec[i] = static_cast<TestType>((i * 7) % 100);
+        }
+
+        REQUIRE(sc::simd::min(vec) == *std::min_element(vec.begin(), vec.end()));
+        REQUIRE(sc::simd::max(vec) == *std::max_element(vec.begin(), vec.end()));
+        REQUIRE(sc::simd::count(vec, TestType(42)) == std::count(vec.begin(), vec.end(), TestType(42)));
+        REQUIRE(sc::simd::find(vec, TestType(42)) == std::find(vec.begin(), vec.end(), TestType(42)) - vec.begin());
+        REQUIRE(sc::simd::find(vec, TestType(100)) == -1);
+        REQUIRE(sc::simd::find(vec.data() + 1000, 1, vec[1000]) == 0);
+
+        // Small values keep the sums exact
+        sc::pod_vector<TestType> ones(size);
+        sc::simd::fill(ones, TestType(1));
+        REQUIRE(std::count(ones.begin(), ones.end(), TestType(1)) == size);
+        REQUIRE(sc::simd::sum(ones.data(), 100) == TestType(100));
+
+        auto copy = vec;
+        REQUIRE(sc::simd::equal(vec, copy));
+        copy[size - 1] = TestType(100);
+        REQUIRE(!sc::simd::equal(vec, copy));
+        copy[size - 1] = vec[size - 1];
+        copy[3] = TestType(100);
+        REQUIRE(!sc::simd::equal(vec, copy));
+    }
+}
+
+TEST_CASE("simd_algorithms against std algorithms", "[simd_algorithms]") {
+    check_against_std<char>();
+    check_against_std<short>();
+    check_against_std<int>();
+    check_against_std<long long>();
+    check_against_std<float>();
+    check_against_std<double>();
+}
@@ -3,6 +3,8 @@
 
 #include <slot_map.hpp>
 #include <atomic>
+#include <algorithm>
+#include <vector>
 #include <iostream>
 
 
@@ -86,3 +88,47 @@ TEST_CASE("slot_map ctors, moves & dtors", "[slot_map]") {
     REQUIRE(movesCounter == dataCount);
     REQUIRE(dtorsCounter == dataCount);
 }
+
+TEST_CASE("slot_map sort & reorder", "[slot_map]") {
+    constexpr int dataCount(16);
+
+    sc::slot_map<int> map;
+    sc::slot_map<int>::key keys[dataCount];
+    for (int i = 0; i < dataCount; ++i) {
+        keys[i] = map.emplace((i * 7) % dataCount);
+    }
+    for (int i = 0; i < dataCount; i += 3) {
+        map.erase(keys[i]);
+    }
+
+    map.sort();
+    REQUIRE(std::is_sorted(map.begin(), map.end()));
+    for (int i = 1; i < dataCount; ++i) {
+        if (i % 3 != 0) REQUIRE(map[keys[i]] == (i * 7) % dataCount);
+    }
+
+    std::vector<int> reversed(static_cast<size_t>(map.size()));
+    for (int i = 0; i < map.size(); ++i) {
+        reversed[i] = map.size() - 1 - i;
+    }
+    map.reorder(reversed);
+    REQUIRE(std::is_sorted(map.begin(), map.end(), std::greater<>()));
+    for (int i = 1; i < dataCount; ++i) {
+        if (i % 3 != 0) REQUIRE(map[keys[i]] == (i * 7) % dataCount);
+    }
+
+    // A rotation is not its own inverse : the position i receives the object at permutation[i]
+    const std::vector<int> before(map.begin(), map.end());
+    std::vector<int> rotation(static_cast<size_t>(map.size()));
+    for (int i = 0; i < map.size(); ++i) {
+        rotation[i] = (i + 1) % map.size();
+    }
+    map.reorder(rotation);
+    const std::vector<int> after(map.begin(), map.end());
+    for (int i = 0; i < map.size(); ++i) {
+        REQUIRE(after[i] == before[rotation[i]]);
+    }
+    for (int i = 1; i < dataCount; ++i) {
+        if (i % 3 != 0) REQUIRE(map[keys[i]] == (i * 7) % dataCount);
+    }
+}
@@ -0,0 +1,56 @@
+#include "catch.hpp"
+#include "small_pod_vector.hpp"
+
+#include <string>
+
+
+TEST_CASE("small_pod_vector inline storage", "[small_pod_vector]") {
+    sc::small_pod_vector<int, 4> vec;
+    REQUIRE(vec.capacity() == 4);
+
+    for (int i = 0; i < 4; ++i) {
+        vec.emplace_back(i);
+    }
+    REQUIRE(vec.is_inline());
+
+    auto vec2 = std::move(vec);
+    REQUIRE(vec2.is_inline());
+    REQUIRE(vec2.size() == 4);
+    REQUIRE(vec.empty());
+
+    // Spills to the heap
+    vec2.emplace_back(4);
+    REQUIRE(!vec2.is_inline());
+    REQUIRE(vec2.capacity() == 8);
+    for (int i = 0; i < 5; ++i) {
+        REQUIRE(vec2[i] == i);
+    }
+
+    auto vec3 = vec2;
+    REQUIRE(std::equal(vec2.begin(), vec2.end(), vec3.begin()));
+
+    vec = std::move(vec2);
+    REQUIRE(!vec.is_inline());
+    REQUIRE(vec2.is_inline());
+
+    // Back to the inline storage
+    vec.resize(2);
+    vec.shrink_to_fit();
+    REQUIRE(vec.is_inline());
+    REQUIRE(vec[1] == 1);
+}
+
+TEST_CASE("small_pod_vector bulk operations", "[small_pod_vector]") {
+    const std::string hello = "hello";
+
+    sc::small_pod_vector<char, 8> vec;
+    vec.append(hello.data(), 5);
+    vec.insert(vec.end(), hello.begin(), hello.end());
+    REQUIRE(std::string(vec.data(), vec.size()) == "hellohello");
+
+    vec.erase(vec.begin() + 2, vec.begin() + 8);
+    REQUIRE(std::string(vec.data(), vec.size()) == "helo");
+
+    vec.assign(hello.begin(), hello.begin() + 2);
+    REQUIRE(std::string(vec.data(), vec.size()) == "he");
+}
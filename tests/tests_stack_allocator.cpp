@@ -1,6 +1,7 @@
 
 #include "catch.hpp"
 #include <stack_allocator.hpp>
+#include <thread>
 
 
 TEST_CASE("stack_allocator basics", "[stack_allocator]") {
@@ -14,20 +15,85 @@ TEST_CASE("stack_allocator basics", "[stack_allocator]") {
         sc::stack_guard lock{ resource };
         vector_t vec{ lock.get_allocator<int>() };
         vec.reserve(10);
-        {
-            bool caught = false;
-            try {
-                vec.reserve(resource.capacity() / sizeof(int));
-            }
-            catch(...) {
-                caught = true;
-            }
-            REQUIRE(caught);
-        }
-        REQUIRE(resource.size() == 7 + 10 * sizeof(int));
+        REQUIRE(reinterpret_cast<uintptr_t>(vec.data()) % alignof(int) == 0);
+        REQUIRE(resource.size() == 8 + 10 * sizeof(int));
     }
     REQUIRE(resource.size() == 7);
 
     resource.pop(7);
     REQUIRE(resource.size() == 0);
 }
+
+TEST_CASE("stack_allocator alignment & chained blocks", "[stack_allocator]") {
+    sc::stack_resource resource(64);
+    {
+        sc::stack_guard guard{ resource };
+        resource.push(1);
+        void* aligned = resource.push(16, 16);
+        REQUIRE(reinterpret_cast<uintptr_t>(aligned) % 16 == 0);
+
+        auto chained = static_cast<char*>(resource.push(100));
+        chained[99] = 'a';
+        REQUIRE(resource.capacity() == 64 + 128);
+    }
+    REQUIRE(resource.size() == 0);
+    {
+        sc::stack_guard guard{ resource };
+        resource.push(100);
+        REQUIRE(resource.capacity() == 64 + 128);
+    }
+    REQUIRE(resource.size() == 0);
+
+    // Padding and skipped block ends are not undone by pop(), rewind() to a saved size is exact
+    resource.push(1);
+    const int mark = resource.size();
+    void* aligned = resource.push(8, 8);
+    resource.push(200);
+    REQUIRE(resource.size() > mark + 8 + 200);
+    resource.rewind(mark);
+    REQUIRE(resource.size() == 1);
+    REQUIRE(resource.push(8, 8) == aligned);
+}
+
+TEST_CASE("stack_allocator frame_resource", "[stack_allocator]") {
+    using vector_t = std::vector<int, sc::stack_allocator<int>>;
+
+    auto& resource = sc::this_thread_frame_resource(256);
+    vector_t vec1{ resource.get_allocator<int>() };
+    vec1.assign(10, 1);
+
+    resource.next_frame();
+    vector_t vec2{ resource.get_allocator<int>() };
+    vec2.assign(10, 2);
+    REQUIRE(vec1[9] == 1);
+    REQUIRE(resource.previous().size() == 10 * sizeof(int));
+
+    resource.next_frame();
+    REQUIRE(resource.current().size() == 0);
+    REQUIRE(vec2[9] == 2);
+    REQUIRE(&sc::this_thread_frame_resource() == &resource);
+    REQUIRE(&sc::this_thread_frame_resource(256) == &resource);
+
+    sc::frame_resource* otherResource = nullptr;
+    std::thread([&] { otherResource = &sc::this_thread_frame_resource(); }).join();
+    REQUIRE(otherResource != &resource);
+}
+
+TEST_CASE("stack_allocator std::pmr resource", "[stack_allocator]") {
+    sc::stack_resource stack(1024);
+    sc::stack_memory_resource resource(stack, 256, std::pmr::null_memory_resource());
+
+    std::pmr::vector<int> vec(&resource);
+    vec.reserve(16);
+    std::pmr::string str("a string too long for small string optimisation", &resource);
+    REQUIRE(stack.size() >= 16 * sizeof(int) + str.size());
+
+    bool caught = false;
+    try {
+        vec.reserve(1024);
+    }
+    catch (std::bad_alloc&) {
+        caught = true;
+    }
+    REQUIRE(caught);
+}
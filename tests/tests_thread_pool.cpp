@@ -1,7 +1,10 @@
 
 #include "catch.hpp"
 #include <thread_pool.hpp>
+#include <slot_map.hpp>
 #include <iostream>
+#include <atomic>
+#include <stdexcept>
 
 TEST_CASE("thread_pool basics", "[thread_pool]") {
     sc::thread_pool threadPool{3};
@@ -18,3 +21,38 @@ TEST_CASE("thread_pool basics", "[thread_pool]") {
     }
     REQUIRE(sum == 50 * 51 / 2);
 }
+
+TEST_CASE("thread_pool parallel algorithms", "[thread_pool]") {
+    sc::thread_pool threadPool{3};
+
+    sc::slot_map<int> map;
+    for (int i = 1; i <= 1000; ++i) {
+        static_cast<void>(map.emplace(i));
+    }
+
+    sc::parallel_for_each(threadPool, map, [] (int& val) { val *= 2; }, 64);
+    const auto sum = sc::parallel_reduce(threadPool, map, 0,
+        [] (int val) { return val; },
+        [] (int v1, int v2) { return v1 + v2; }, 64);
+    REQUIRE(sum == 1000 * 1001);
+
+    sc::slot_map<int> empty;
+    REQUIRE(sc::parallel_reduce(threadPool, empty, 7,
+        [] (int val) { return val; },
+        [] (int v1, int v2) { return v1 + v2; }) == 7);
+
+    // Exceptions are rethrown once every chunk is done, in the calling thread or in the pool
+    for (int thrower : {1, 500}) {
+        std::atomic<int> processed{0};
+        REQUIRE_THROWS_AS(sc::parallel_for_each(threadPool, map, [&processed, thrower] (int& val) {
+            if (val == 2 * thrower) throw std::runtime_error("chunk failed");
+            ++processed;
+        }, 64), std::runtime_error);
+        REQUIRE(processed.load() >= 1000 - 64);
+    }
+
+    // Invalid grains are clamped
+    REQUIRE(sc::parallel_reduce(threadPool, map, 0,
+        [] (int val) { return val; },
+        [] (int v1, int v2) { return v1 + v2; }, 0) == 1000 * 1001);
+}
@@ -51,3 +51,31 @@ TEST_CASE("type_traits efficient_argument_t", "[type_traits]") {
     // Selection on ctor
     REQUIRE( std::is_reference_v<sc::efficient_argument_t<slow_copy_t>>);
 }
+
+namespace {
+    struct relocatable_t {
+        relocatable_t(relocatable_t&&) {}
+    };
+    struct self_referencing_t {
+        self_referencing_t() : self(this) {}
+        self_referencing_t(self_referencing_t&&) : self(this) {}
+        self_referencing_t* self;
+    };
+    // The opt-in is not inherited
+    struct derived_self_referencing_t : relocatable_t {
+        derived_self_referencing_t(derived_self_referencing_t&& d) : relocatable_t(std::move(d)), self(this) {}
+        derived_self_referencing_t* self;
+    };
+}
+namespace sc {
+    template<> constexpr bool is_trivially_relocatable<relocatable_t> = true;
+}
+
+TEST_CASE("type_traits is_trivially_relocatable", "[type_traits]") {
+    REQUIRE( sc::is_trivially_relocatable<int>);
+    REQUIRE( sc::is_trivially_relocatable<fast_copy_t>);
+    REQUIRE( sc::is_trivially_relocatable<relocatable_t>);
+    REQUIRE( sc::is_trivially_relocatable<relocatable_t const>);
+    REQUIRE(!sc::is_trivially_relocatable<self_referencing_t>);
+    REQUIRE(!sc::is_trivially_relocatable<derived_self_referencing_t>);
+}